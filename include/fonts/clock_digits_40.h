@@ -0,0 +1,9 @@
+#pragma once
+
+#include <lvgl.h>
+
+/* 时钟数字图集：0-9 为数字，CLOCK_DIGITS_40_COLON 为冒号，由 scripts/gen_digit_atlas.py 生成 */
+#define CLOCK_DIGITS_40_COLON 10
+#define CLOCK_DIGITS_40_COUNT 11
+
+extern const lv_img_dsc_t clock_digits_40[CLOCK_DIGITS_40_COUNT];
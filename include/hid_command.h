@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+#include <zephyr/sys/iterable_sections.h>
+
+/* 协议版本，随能力查询返回给主机 */
+#define HID_PROTOCOL_VERSION 1
+
+/* TLV 帧命令：一条报告携带多条命令，见 hid_command.c */
+#define HID_CMD_FRAME 0xB0
+#define HID_FRAME_VERSION 1
+#define HID_FRAME_HEADER_LEN 3  // version, seq, count
+
+/* 查询命令，请求与回复使用同一个 ID，见 hid_response.c */
+#define HID_CMD_CAPABILITIES 0xAE
+#define HID_CMD_STATE 0xAF
+
+/* 只能查询、不能设置的状态记录 */
+#define HID_STATE_BRIGHTNESS 0xC0     // [有效亮度][基础亮度][modifier][屏幕开关][设置写入 flash 次数 u32]
+#define HID_STATE_LAYER 0xC1          // [最高激活层]
+#define HID_STATE_BATTERY 0xC2        // [外设 0 电量][外设 1 电量]...
+#define HID_STATE_DISPLAY_POWER 0xC3  // [电源状态][平均电流 uA，uint32 小端]
+#define HID_STATE_CANVAS 0xC4         // [上一区域 像素/秒 u32][平均 像素/秒 u32][压缩比 x100 u16][错误数 u16]
+#define HID_STATE_BATTERY_ETA 0xC5    // 每个来源 [电量][速率 0.01%/h i16][剩余分钟 u16，0xFFFF 未知]
+
+/**
+ * @brief HID 命令处理函数
+ *
+ * 既用于单命令报告，也用于 TLV 帧中的一条记录，两者的 payload 格式相同。
+ *
+ * @param payload 命令字节之后的数据
+ * @param len payload 长度，至少为注册时的 min_len
+ * @return 0 表示成功，负数为错误码
+ */
+typedef int (*hid_command_handler_t)(const uint8_t *payload, uint8_t len);
+
+/**
+ * @brief 状态查询函数，写出该命令当前的值，格式与命令 payload 相同
+ *
+ * @param out 输出缓冲区
+ * @param max_len 缓冲区大小
+ * @return 写入的字节数；-ENOSPC 表示缓冲区不够，其他负数表示当前没有可报告的值
+ */
+typedef int (*hid_state_query_t)(uint8_t *out, uint8_t max_len);
+
+struct hid_command {
+    uint8_t id;       // 报告第一个字节
+    uint8_t min_len;  // payload 最小长度，不足时不调用 handler
+    hid_command_handler_t handler;  // NULL 表示只能查询
+    hid_state_query_t query;        // NULL 表示不出现在状态快照中
+};
+
+#define HID_COMMAND_ENTRY(name, _id, _min_len, _handler, _query)                                   \
+    const STRUCT_SECTION_ITERABLE(hid_command, _CONCAT(hid_command_, name)) = {                    \
+        .id = (_id),                                                                               \
+        .min_len = (_min_len),                                                                     \
+        .handler = (_handler),                                                                     \
+        .query = (_query),                                                                         \
+    }
+
+/**
+ * @brief 注册一个 HID 命令，用法类似 ZMK_LISTENER
+ *
+ * 每个命令 ID 只能注册一次，可以放在任意模块中，无需修改分发代码。
+ */
+#define HID_COMMAND_DEFINE(name, _id, _min_len, _handler)                                          \
+    HID_COMMAND_ENTRY(name, _id, _min_len, _handler, NULL)
+
+/**
+ * @brief 注册一个 HID 命令，并把它的当前值加入状态快照
+ */
+#define HID_COMMAND_DEFINE_WITH_STATE(name, _id, _min_len, _handler, _query)                       \
+    HID_COMMAND_ENTRY(name, _id, _min_len, _handler, _query)
+
+/**
+ * @brief 注册一条只读状态记录（HID_STATE_*）
+ */
+#define HID_STATE_DEFINE(name, _id, _query) HID_COMMAND_ENTRY(name, _id, 0, NULL, _query)
+
+/**
+ * @brief 分发一条报告到对应的命令
+ *
+ * @param data 完整报告，data[0] 为命令 ID
+ * @param len 报告长度
+ * @return 0 表示成功，-ENOTSUP 未知命令，-EMSGSIZE 长度不足，其他为 handler 返回值
+ */
+int hid_command_dispatch(const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 按 ID 查找已注册的命令或状态记录
+ */
+const struct hid_command *hid_command_find(uint8_t id);
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+
+/*
+ * 回复报告格式（固定 CONFIG_RAW_HID_REPORT_SIZE 字节，多余部分补 0）：
+ *   ACK:  [HID_RSP_ACK][seq][status][count][记录 0 状态]...[记录 count-1 状态]
+ *   能力: [HID_CMD_CAPABILITIES][seq][协议版本][帧版本][报告长度][队列长度][n][命令 ID * n]
+ *   状态: [HID_CMD_STATE][seq][count][more] { [type][len][value * len] } * count
+ */
+#define HID_RSP_ACK 0xA0
+
+/* ACK 中最多列出的记录状态数 */
+#define HID_ACK_MAX_RECORDS (CONFIG_RAW_HID_REPORT_SIZE - 4)
+
+/**
+ * @brief 回复中的状态码，与固件的 errno 取值无关
+ */
+enum hid_status {
+    HID_STATUS_OK = 0,
+    HID_STATUS_UNKNOWN_COMMAND = 1,
+    HID_STATUS_BAD_LENGTH = 2,
+    HID_STATUS_BAD_VERSION = 3,
+    HID_STATUS_NOT_READY = 4,  // 对应的 widget 还没有创建
+    HID_STATUS_FAILED = 5,
+    HID_STATUS_BAD_ARGUMENT = 6,
+    HID_STATUS_BAD_OFFSET = 7,  // 上传块不连续，回复中带有期望的偏移
+    HID_STATUS_BAD_CRC = 8,
+};
+
+/**
+ * @brief 把 handler 返回的错误码转换为状态码
+ */
+uint8_t hid_response_status(int err);
+
+/**
+ * @brief 发送一条回复报告，不足报告长度的部分补 0
+ *
+ * 只能在 HID 处理工作中调用（显示工作队列），回复缓冲区只有一个。
+ */
+int hid_response_send(const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 发送 ACK
+ *
+ * @param statuses 每条记录的状态，可以为 NULL
+ * @param count statuses 的数量
+ */
+int hid_response_ack(uint8_t seq, uint8_t status, const uint8_t *statuses, uint8_t count);
@@ -2,8 +2,55 @@
 #include <stdint.h>
 
 /**
- * @brief 获取最新接收到的 Raw HID 数据
- * 
- * @return const uint8_t* 指向 CONFIG_RAW_HID_REPORT_SIZE 长度的数据
+ * @brief 一条接收到的 Raw HID 报告
  */
-const uint8_t *raw_hid_bridge_get_buffer(void);
+struct raw_hid_report {
+    uint8_t data[CONFIG_RAW_HID_REPORT_SIZE];
+    uint8_t length;  // 实际接收长度，data 中多余部分补 0
+    uint32_t rx_cycles;  // 接收时的 k_cycle_get_32()，用于延迟统计
+};
+
+/**
+ * @brief 队列统计
+ */
+struct raw_hid_bridge_stats {
+    uint32_t received;    // 已入队的报告数
+    uint32_t dropped;     // 队列满时丢弃的报告数
+    uint32_t high_water;  // 队列曾经达到的最大深度
+    uint32_t capacity;
+    uint32_t latency_last_us;  // 最近一条报告从接收到处理完成的时间
+    uint32_t latency_max_us;
+    uint32_t latency_avg_us;
+};
+
+/**
+ * @brief 新报告入队后的通知回调，在生产者上下文中调用
+ */
+typedef void (*raw_hid_bridge_notify_t)(void);
+
+/**
+ * @brief 查看队列中最早的报告，不出队
+ *
+ * 返回的指针在 raw_hid_bridge_pop() 之前一直有效，生产者不会覆盖它。
+ * 只能由唯一的消费者调用。
+ *
+ * @return 队列为空时返回 NULL
+ */
+const struct raw_hid_report *raw_hid_bridge_peek(void);
+
+/**
+ * @brief 释放 raw_hid_bridge_peek() 返回的报告
+ *
+ * 在报告处理完成后调用，同时记录从接收到此刻的延迟。
+ */
+void raw_hid_bridge_pop(void);
+
+/**
+ * @brief 获取队列统计
+ */
+void raw_hid_bridge_get_stats(struct raw_hid_bridge_stats *stats);
+
+/**
+ * @brief 注册新报告通知，消费者在回调中提交处理工作即可
+ */
+void raw_hid_bridge_set_notify(raw_hid_bridge_notify_t notify);
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""
+通过 Raw HID 把图片上传到 dongle 的 asset_partition 槽位。
+
+用法：
+    python3 asset_upload.py --slot 0 cat.png
+    python3 asset_upload.py --slot 1 --cf 7 --width 50 --height 26 frame.bin
+
+PNG 会转换为 LV_IMG_CF_TRUE_COLOR（RGB565，字节交换，对应 LV_COLOR_16_SWAP=y）。
+其他文件按原样上传，需要给出 LVGL 颜色格式和尺寸。
+固件只接受 LVGL 内置解码器支持的格式，数据长度不能小于宽、高和格式对应的字节数。
+
+bongo cat 的帧可以用上传的图片替换：设置 CONFIG_DONGLE_SCREEN_BONGO_CAT_ASSET_SLOT，
+帧 N（enum bongo_cat_frame 的顺序）使用槽位 SLOT + N。
+
+连接断开或超时后会重新打开设备，用 STATUS 查询固件已收到的偏移并继续上传。
+槽位中正在上传的文件与本次的大小、CRC、尺寸或格式不同时，重新 BEGIN。
+依赖：pip install hidapi pillow
+
+没有自动化测试：native_sim 没有 ZMK 的 USB/BLE Raw HID 传输，脚本也没有模拟传输。
+上传和断线续传只能在设备上验证（上传过程中拔插 USB）。
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+import hid
+
+# 与 zmk-raw-hid 一致
+USAGE_PAGE = 0xFF60
+USAGE = 0x61
+REPORT_SIZE = 32
+
+CMD_BEGIN = 0xB8
+CMD_CHUNK = 0xB9
+CMD_COMMIT = 0xBA
+CMD_STATUS = 0xBB
+
+STATE_EMPTY = 0
+STATE_UPLOADING = 1
+STATE_VALID = 2
+
+STATUS_NAMES = {
+    0: "ok", 1: "unknown command", 2: "bad length", 3: "bad version", 4: "not ready",
+    5: "failed", 6: "bad argument", 7: "bad offset", 8: "bad crc",
+}
+
+LV_IMG_CF_TRUE_COLOR = 4
+
+# 每块数据：报告 - 命令 - seq - offset(4) - n
+CHUNK_SIZE = REPORT_SIZE - 7
+
+
+class UploadError(Exception):
+    pass
+
+
+def png_to_rgb565(path):
+    from PIL import Image
+
+    img = Image.open(path).convert("RGB")
+    out = bytearray()
+    for r, g, b in img.getdata():
+        v = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+        out += struct.pack(">H", v)  # LV_COLOR_16_SWAP：高字节在前
+    return bytes(out), img.width, img.height, LV_IMG_CF_TRUE_COLOR
+
+
+class Device:
+    def __init__(self, vid, pid, timeout_ms):
+        self.vid = vid
+        self.pid = pid
+        self.timeout_ms = timeout_ms
+        self.dev = None
+        self.seq = 0
+
+    def open(self):
+        for info in hid.enumerate(self.vid, self.pid):
+            if info["usage_page"] == USAGE_PAGE and info["usage"] == USAGE:
+                self.dev = hid.device()
+                self.dev.open_path(info["path"])
+                return
+        raise UploadError("找不到 Raw HID 设备")
+
+    def close(self):
+        if self.dev:
+            self.dev.close()
+            self.dev = None
+
+    def request(self, cmd, payload):
+        """发送一条命令并等待同一命令 ID、同一 seq 的回复"""
+        self.seq = (self.seq + 1) & 0xFF
+        report = bytes([cmd, self.seq]) + payload
+        report = report.ljust(REPORT_SIZE, b"\0")
+        self.dev.write(b"\0" + report)  # 报告 ID 0
+
+        deadline = time.monotonic() + self.timeout_ms / 1000
+        while time.monotonic() < deadline:
+            rsp = bytes(self.dev.read(REPORT_SIZE, self.timeout_ms))
+            if len(rsp) >= 22 and rsp[0] == cmd and rsp[1] == self.seq:
+                status, slot, state = rsp[2], rsp[3], rsp[4]
+                (offset,) = struct.unpack_from("<I", rsp, 5)
+                # 槽位中上传或图片的 (size, crc, width, height, cf)
+                info = struct.unpack_from("<IIHHB", rsp, 9)
+                return status, slot, state, offset, info
+        raise TimeoutError("等待回复超时")
+
+
+def upload(dev, slot, data, cf, width, height):
+    crc = zlib.crc32(data) & 0xFFFFFFFF
+
+    status, _, state, offset, info = dev.request(CMD_STATUS, bytes([slot]))
+    # 只继续同一个文件的上传，槽位中是别的文件的半截上传时重新开始
+    if state == STATE_UPLOADING and info == (len(data), crc, width, height, cf):
+        print(f"继续上传，偏移 {offset}")
+    else:
+        begin = struct.pack("<BBHHII", slot, cf, width, height, len(data), crc)
+        status, _, state, offset, _ = dev.request(CMD_BEGIN, begin)
+        if status != 0:
+            raise UploadError("BEGIN 失败: " + STATUS_NAMES.get(status, str(status)))
+
+    while offset < len(data):
+        chunk = data[offset:offset + CHUNK_SIZE]
+        status, _, state, next_offset, _ = dev.request(
+            CMD_CHUNK, struct.pack("<IB", offset, len(chunk)) + chunk)
+        # bad offset 时固件回复期望的偏移，直接从那里继续
+        if status not in (0, 7):
+            raise UploadError("CHUNK 失败: " + STATUS_NAMES.get(status, str(status)))
+        offset = next_offset
+        print(f"\r{offset}/{len(data)} 字节", end="", flush=True)
+    print()
+
+    status, _, state, size, _ = dev.request(CMD_COMMIT, b"")
+    if status != 0 or state != STATE_VALID:
+        raise UploadError("COMMIT 失败: " + STATUS_NAMES.get(status, str(status)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="上传图片到 dongle 屏幕的 flash 槽位")
+    parser.add_argument("file")
+    parser.add_argument("--slot", type=int, required=True)
+    parser.add_argument("--cf", type=int, help="LVGL 颜色格式 (lv_img_cf_t)，非 PNG 文件必须给出")
+    parser.add_argument("--width", type=int)
+    parser.add_argument("--height", type=int)
+    parser.add_argument("--vid", type=lambda v: int(v, 0), default=0)
+    parser.add_argument("--pid", type=lambda v: int(v, 0), default=0)
+    parser.add_argument("--timeout", type=int, default=1000, help="单条回复超时 (ms)")
+    parser.add_argument("--retries", type=int, default=10, help="断开后重试次数")
+    args = parser.parse_args()
+
+    if args.file.lower().endswith(".png"):
+        data, width, height, cf = png_to_rgb565(args.file)
+    else:
+        if args.cf is None or args.width is None or args.height is None:
+            parser.error("非 PNG 文件需要 --cf --width --height")
+        with open(args.file, "rb") as f:
+            data = f.read()
+        width, height, cf = args.width, args.height, args.cf
+
+    dev = Device(args.vid, args.pid, args.timeout)
+    for attempt in range(args.retries + 1):
+        try:
+            dev.open()
+            upload(dev, args.slot, data, cf, width, height)
+            print(f"槽位 {args.slot}: {width}x{height}, {len(data)} 字节，上传完成")
+            return 0
+        except (OSError, IOError, TimeoutError) as e:
+            print(f"\n连接中断 ({e})，重试 {attempt + 1}/{args.retries}", file=sys.stderr)
+            time.sleep(1)
+        except UploadError as e:
+            print(f"\n{e}", file=sys.stderr)
+            return 1
+        finally:
+            dev.close()
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
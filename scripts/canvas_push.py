@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+"""
+向 dongle 的主机画布（CONFIG_DONGLE_SCREEN_HOST_CANVAS）推送画面区域。
+
+用法：
+    python3 canvas_push.py image cover.png --x 0 --y 0 --fmt rle
+    python3 canvas_push.py sparkline --fps 5
+    python3 canvas_push.py bench --fmt raw --count 20
+
+bench 分别测量主机端（发送第一条报告到收到完成回复）和固件端（HID_STATE_CANVAS）
+的像素/秒。通过 USB 和 BLE 连接各运行一次即可比较两种传输。
+依赖：pip install hidapi pillow
+"""
+
+import argparse
+import random
+import struct
+import sys
+import time
+
+import hid
+
+USAGE_PAGE = 0xFF60
+USAGE = 0x61
+REPORT_SIZE = 32
+
+CMD_REGION = 0xBC
+CMD_DATA = 0xBD
+CMD_PALETTE = 0xBE
+CMD_CTRL = 0xBF
+CMD_STATE = 0xAF
+STATE_CANVAS = 0xC4
+
+FMT_RGB565 = 0
+FMT_RGB565_RLE = 1
+FMT_INDEXED_RLE = 2
+FMT_INDEXED4 = 3
+FORMATS = {"raw": FMT_RGB565, "rle": FMT_RGB565_RLE, "irle": FMT_INDEXED_RLE, "i4": FMT_INDEXED4}
+
+OP_SCROLL = 2
+
+# DATA 报告：[cmd][idx][n][data * n]
+DATA_MAX = REPORT_SIZE - 3
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+# ============================
+#      编码，单元不跨报告
+# ============================
+
+def encode_rgb565(pixels):
+    return [struct.pack(">H", p) for p in pixels]
+
+
+def encode_rgb565_rle(pixels):
+    units = []
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and run < 256 and pixels[i + run] == pixels[i]:
+            run += 1
+        units.append(struct.pack(">BH", run - 1, pixels[i]))
+        i += run
+    return units
+
+
+def encode_indexed_rle(indices):
+    units = []
+    i = 0
+    while i < len(indices):
+        run = 1
+        while i + run < len(indices) and run < 16 and indices[i + run] == indices[i]:
+            run += 1
+        units.append(bytes([(run - 1) << 4 | indices[i]]))
+        i += run
+    return units
+
+
+def encode_indexed4(indices):
+    padded = indices + [0] * (len(indices) % 2)
+    return [bytes([padded[i] << 4 | padded[i + 1]]) for i in range(0, len(padded), 2)]
+
+
+def pack_reports(units):
+    reports = []
+    cur = b""
+    for u in units:
+        if len(cur) + len(u) > DATA_MAX:
+            reports.append(cur)
+            cur = b""
+        cur += u
+    if cur:
+        reports.append(cur)
+    return reports
+
+
+class Canvas:
+    def __init__(self, vid, pid, timeout_ms):
+        self.timeout_ms = timeout_ms
+        self.seq = 0
+        for info in hid.enumerate(vid, pid):
+            if info["usage_page"] == USAGE_PAGE and info["usage"] == USAGE:
+                self.dev = hid.device()
+                self.dev.open_path(info["path"])
+                return
+        raise SystemExit("找不到 Raw HID 设备")
+
+    def send(self, data):
+        self.dev.write(b"\0" + bytes(data).ljust(REPORT_SIZE, b"\0"))
+
+    def wait(self, cmd, seq):
+        deadline = time.monotonic() + self.timeout_ms / 1000
+        while time.monotonic() < deadline:
+            rsp = bytes(self.dev.read(REPORT_SIZE, self.timeout_ms))
+            if len(rsp) >= 3 and rsp[0] == cmd and rsp[1] == seq:
+                return rsp
+        raise TimeoutError("等待回复超时")
+
+    def next_seq(self):
+        self.seq = (self.seq + 1) & 0xFF
+        return self.seq
+
+    def palette(self, start, colors):
+        for i in range(0, len(colors), 14):
+            part = colors[i:i + 14]
+            self.send(bytes([CMD_PALETTE, self.next_seq(), start + i, len(part)])
+                      + b"".join(struct.pack(">H", c) for c in part))
+
+    def region(self, x, y, w, h, fmt, units):
+        """发送一个区域并等待完成回复，返回固件端像素/秒"""
+        seq = self.next_seq()
+        self.send(struct.pack("<BBBHHHH", CMD_REGION, seq, fmt, x, y, w, h))
+        for idx, data in enumerate(pack_reports(units)):
+            self.send(bytes([CMD_DATA, idx & 0xFF, len(data)]) + data)
+        rsp = self.wait(CMD_REGION, seq)
+        if rsp[2] != 0:
+            raise RuntimeError(f"区域失败，状态 {rsp[2]}")
+        return struct.unpack_from("<I", rsp, 3)[0]
+
+    def scroll(self, x, y, w, h, dx):
+        self.send(struct.pack("<BBBHHHHb", CMD_CTRL, self.next_seq(), OP_SCROLL, x, y, w, h, dx))
+
+    def stats(self):
+        seq = self.next_seq()
+        self.send(bytes([CMD_STATE, seq, STATE_CANVAS]))
+        rsp = self.wait(CMD_STATE, seq)
+        if rsp[2] == 0:
+            return None
+        return struct.unpack_from("<IIHH", rsp, 6)
+
+
+def load_image(path):
+    from PIL import Image
+
+    img = Image.open(path).convert("RGB")
+    return img.width, img.height, [rgb565(*p) for p in img.getdata()]
+
+
+def cmd_image(canvas, args):
+    w, h, pixels = load_image(args.file)
+    fmt = FORMATS[args.fmt]
+    if fmt == FMT_RGB565:
+        units = encode_rgb565(pixels)
+    elif fmt == FMT_RGB565_RLE:
+        units = encode_rgb565_rle(pixels)
+    else:
+        raise SystemExit("图片只支持 raw 和 rle 格式")
+    pps = canvas.region(args.x, args.y, w, h, fmt, units)
+    print(f"{w}x{h}，{len(pack_reports(units))} 条报告，固件端 {pps} 像素/秒")
+
+
+def cmd_sparkline(canvas, args):
+    """每帧左移一列，只发送最右边新的一列"""
+    w, h = args.width, args.height
+    canvas.palette(0, [rgb565(0, 0, 0), rgb565(0, 255, 0)])
+    canvas.region(0, 0, w, h, FMT_INDEXED_RLE, encode_indexed_rle([0] * (w * h)))
+
+    value = h // 2
+    period = 1 / args.fps
+    while True:
+        start = time.monotonic()
+        value = max(0, min(h - 1, value + random.randint(-3, 3)))
+        column = [1 if h - 1 - r == value else 0 for r in range(h)]
+        canvas.scroll(0, 0, w, h, 1)
+        canvas.region(w - 1, 0, 1, h, FMT_INDEXED_RLE, encode_indexed_rle(column))
+        time.sleep(max(0, period - (time.monotonic() - start)))
+
+
+def cmd_bench(canvas, args):
+    w, h = args.width, args.height
+    fmt = FORMATS[args.fmt]
+    total_px = 0
+    start = time.monotonic()
+    for _ in range(args.count):
+        if fmt in (FMT_RGB565, FMT_RGB565_RLE):
+            # 随机色块，RLE 有一定压缩但不是最好情况
+            pixels = []
+            while len(pixels) < w * h:
+                pixels += [random.randrange(0x10000)] * random.randint(1, 12)
+            pixels = pixels[:w * h]
+            units = encode_rgb565(pixels) if fmt == FMT_RGB565 else encode_rgb565_rle(pixels)
+        else:
+            indices = [random.randrange(16) for _ in range(w * h)]
+            units = encode_indexed4(indices) if fmt == FMT_INDEXED4 else encode_indexed_rle(indices)
+        canvas.region(0, 0, w, h, fmt, units)
+        total_px += w * h
+    elapsed = time.monotonic() - start
+
+    print(f"主机端: {total_px / elapsed:.0f} 像素/秒 ({args.count} 个 {w}x{h} 区域，{elapsed:.2f} s)")
+    stats = canvas.stats()
+    if stats:
+        last, avg, ratio, errors = stats
+        print(f"固件端: 上一区域 {last} 像素/秒，平均 {avg} 像素/秒，压缩比 {ratio / 100:.2f}，错误 {errors}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="向 dongle 屏幕推送画面区域")
+    parser.add_argument("--vid", type=lambda v: int(v, 0), default=0)
+    parser.add_argument("--pid", type=lambda v: int(v, 0), default=0)
+    parser.add_argument("--timeout", type=int, default=2000, help="等待区域完成的超时 (ms)")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    p = sub.add_parser("image")
+    p.add_argument("file")
+    p.add_argument("--x", type=int, default=0)
+    p.add_argument("--y", type=int, default=0)
+    p.add_argument("--fmt", choices=["raw", "rle"], default="rle")
+
+    p = sub.add_parser("sparkline")
+    p.add_argument("--width", type=int, default=160)
+    p.add_argument("--height", type=int, default=64)
+    p.add_argument("--fps", type=float, default=5)
+
+    p = sub.add_parser("bench")
+    p.add_argument("--width", type=int, default=64)
+    p.add_argument("--height", type=int, default=64)
+    p.add_argument("--fmt", choices=list(FORMATS), default="raw")
+    p.add_argument("--count", type=int, default=20)
+
+    args = parser.parse_args()
+    canvas = Canvas(args.vid, args.pid, args.timeout)
+    {"image": cmd_image, "sparkline": cmd_sparkline, "bench": cmd_bench}[args.cmd](canvas, args)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+从 bongo_cat_images.c 计算每两帧之间变化的矩形，生成 bongo_cat_diff.c/.h。
+
+切换帧时 widget 只刷新这些矩形，而不是整个 50x26 的图片。
+每对帧最多 BONGO_CAT_DIFF_RECTS 个矩形：左右爪子同时变化时分成两块，
+中间不变的部分不刷新。
+
+用法（在仓库根目录）：
+    python3 scripts/gen_bongo_cat_diff.py
+
+修改帧图片后重新运行并提交生成的文件。
+"""
+
+import re
+
+IMAGE_FILE = "src/widgets/bongo_cat_images.c"
+OUTPUT_C = "src/widgets/bongo_cat_diff.c"
+OUTPUT_H = "src/widgets/bongo_cat_diff.h"
+
+MAX_RECTS = 2
+# 两块变化之间至少隔这么多列不变才分开，太近时合并更省刷新次数
+MIN_GAP = 4
+
+# FAST 档的帧序列和周期，与 bongo_cat.c 中的 fast_frames / ANIMATION_SPEED_FAST 一致，用于统计
+FAST_SEQUENCE = ["both2", "both1", "none", "none"]
+FAST_PERIOD_MS = 200
+
+
+def parse_frames(path):
+    with open(path) as f:
+        content = f.read()
+
+    frames = {}
+    for name, body in re.findall(r"uint8_t\s+bongo_cat_(\w+)_map\[\]\s*=\s*\{(.*?)\};", content, re.S):
+        body = re.sub(r"/\*.*?\*/", "", body)
+        data = [int(h, 16) for h in re.findall(r"0x[0-9a-fA-F]+", body)]
+        frames[name] = data[8:]  # 跳过 2 色调色板
+
+    sizes = dict(re.findall(r"\.header\.(w|h)\s*=\s*(\d+)", content))
+    return frames, int(sizes["w"]), int(sizes["h"])
+
+
+def pixel(data, w, x, y):
+    stride = (w + 7) // 8
+    return (data[y * stride + x // 8] >> (7 - x % 8)) & 1
+
+
+def diff_rects(a, b, w, h):
+    changed = [(x, y) for y in range(h) for x in range(w) if pixel(a, w, x, y) != pixel(b, w, x, y)]
+    if not changed:
+        return []
+
+    # 按列分组，中间有足够宽的空列时分成两块
+    cols = sorted({x for x, _ in changed})
+    groups = [[cols[0]]]
+    for x in cols[1:]:
+        if x - groups[-1][-1] > MIN_GAP and len(groups) < MAX_RECTS:
+            groups.append([x])
+        else:
+            groups[-1].append(x)
+
+    rects = []
+    for g in groups:
+        ys = [y for x, y in changed if g[0] <= x <= g[-1]]
+        rects.append((g[0], min(ys), g[-1], max(ys)))
+    return rects
+
+
+def area(rects):
+    return sum((x2 - x1 + 1) * (y2 - y1 + 1) for x1, y1, x2, y2 in rects)
+
+
+def main():
+    frames, w, h = parse_frames(IMAGE_FILE)
+    names = list(frames)
+
+    table = {(a, b): diff_rects(frames[a], frames[b], w, h) for a in names for b in names}
+
+    # FAST 档每秒刷新的像素：之前每次换帧刷新整张图，之后只刷新变化的矩形
+    steps = len(FAST_SEQUENCE) * 1000 // FAST_PERIOD_MS
+    pairs = list(zip(FAST_SEQUENCE, FAST_SEQUENCE[1:] + FAST_SEQUENCE[:1]))
+    before = w * h * steps
+    after = sum(area(table[p]) for p in pairs) * 1000 // FAST_PERIOD_MS
+
+    enum_names = [f"BONGO_CAT_FRAME_{n.upper()}" for n in names]
+
+    # 调色板 + 像素数据的字节数，widget 按这个大小在 RAM 中复制帧数据
+    data_size = {len(d) + 8 for d in frames.values()}
+    assert len(data_size) == 1, "所有帧的大小必须相同"
+    data_size = data_size.pop()
+
+    h_out = [
+        "#pragma once",
+        "",
+        "/* 由 scripts/gen_bongo_cat_diff.py 从 bongo_cat_images.c 生成，不要手动修改 */",
+        "",
+        "#include <stdint.h>",
+        "#include <lvgl.h>",
+        "",
+        "enum bongo_cat_frame {",
+    ]
+    h_out += [f"    {e}," for e in enum_names]
+    h_out += [
+        "    BONGO_CAT_FRAME_COUNT,",
+        "};",
+        "",
+        f"#define BONGO_CAT_DIFF_RECTS {MAX_RECTS}",
+        "",
+        "/* 每帧的数据大小（2 色调色板 + 1 位像素） */",
+        f"#define BONGO_CAT_FRAME_DATA_SIZE {data_size}",
+        "",
+        "/* 相对图片左上角的矩形，包含两端；x2 < x1 表示未使用 */",
+        "struct bongo_cat_rect {",
+        "    uint8_t x1, y1, x2, y2;",
+        "};",
+        "",
+        "extern const lv_img_dsc_t *const bongo_cat_frames[BONGO_CAT_FRAME_COUNT];",
+        "",
+        "/* bongo_cat_diff[从][到]：两帧之间变化的区域 */",
+        "extern const struct bongo_cat_rect",
+        "    bongo_cat_diff[BONGO_CAT_FRAME_COUNT][BONGO_CAT_FRAME_COUNT][BONGO_CAT_DIFF_RECTS];",
+    ]
+
+    c_out = [
+        "/*",
+        " * 由 scripts/gen_bongo_cat_diff.py 从 bongo_cat_images.c 生成，不要手动修改",
+        f" * FAST 档每秒刷新像素：整帧 {before}，按矩形 {after}",
+        " */",
+        "",
+        "#include <lvgl.h>",
+        '#include "bongo_cat_diff.h"',
+        "",
+    ]
+    c_out += [f"LV_IMG_DECLARE(bongo_cat_{n});" for n in names]
+    c_out += ["", "const lv_img_dsc_t *const bongo_cat_frames[BONGO_CAT_FRAME_COUNT] = {"]
+    c_out += [f"    [{e}] = &bongo_cat_{n}," for e, n in zip(enum_names, names)]
+    c_out += ["};", "", "const struct bongo_cat_rect",
+              "    bongo_cat_diff[BONGO_CAT_FRAME_COUNT][BONGO_CAT_FRAME_COUNT][BONGO_CAT_DIFF_RECTS] = {"]
+    for a, ea in zip(names, enum_names):
+        c_out.append(f"    [{ea}] = {{")
+        for b, eb in zip(names, enum_names):
+            rects = table[(a, b)] + [(1, 0, 0, 0)] * (MAX_RECTS - len(table[(a, b)]))
+            cells = ", ".join("{%d, %d, %d, %d}" % r for r in rects)
+            c_out.append(f"        [{eb}] = {{{cells}}},")
+        c_out.append("    },")
+    c_out.append("};")
+
+    with open(OUTPUT_H, "w") as f:
+        f.write("\n".join(h_out) + "\n")
+    with open(OUTPUT_C, "w") as f:
+        f.write("\n".join(c_out) + "\n")
+
+    print(f"{len(names)} 帧，{w}x{h}")
+    print(f"FAST 档每秒刷新像素：整帧 {before}，按矩形 {after}")
+
+
+if __name__ == "__main__":
+    main()
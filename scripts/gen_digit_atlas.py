@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+从 lv_font_jetbrainsmono_40.c 生成时钟数字图集（0-9 和 :）。
+
+每个字符按 LVGL 标签的排版画进一个等宽字符格（adv_w x line_height），
+按固定的前景色和背景色预先混合为 RGB565（LV_COLOR_16_SWAP 字节顺序），
+时钟直接显示这些图片，不再经过 LVGL 的字体渲染。
+
+用法（在仓库根目录）：
+    python3 scripts/gen_digit_atlas.py
+    python3 scripts/gen_digit_atlas.py --fg ffffff --bg 000000
+
+修改字体或颜色后重新运行并提交生成的文件。
+"""
+
+import argparse
+import re
+
+FONT_FILE = "src/fonts/lv_font_jetbrainsmono_40.c"
+OUTPUT_FILE = "src/fonts/clock_digits_40.c"
+SYMBOLS = "0123456789:"
+
+
+def parse_font(path):
+    with open(path) as f:
+        content = f.read()
+
+    bitmap = re.search(r"glyph_bitmap\[\]\s*=\s*\{(.*?)\};", content, re.S).group(1)
+    bitmap = [int(h, 16) for h in re.findall(r"0x[0-9a-fA-F]+", re.sub(r"/\*.*?\*/", "", bitmap))]
+
+    # 跳过注释掉的旧 glyph_dsc，只取实际使用的那一份
+    code = re.sub(r"/\*.*?\*/", "", content, flags=re.S)
+    dsc_block = re.search(r"glyph_dsc\[\]\s*=\s*\{(.*?)\};", code, re.S).group(1)
+    glyphs = []
+    for entry in re.findall(r"\{([^{}]*)\}", dsc_block):
+        fields = dict(re.findall(r"\.(\w+)\s*=\s*(-?\d+)", entry))
+        glyphs.append({k: int(v) for k, v in fields.items()})
+
+    line_height = int(re.search(r"\.line_height\s*=\s*(\d+)", code).group(1))
+    base_line = int(re.search(r"\.base_line\s*=\s*(-?\d+)", code).group(1))
+    bpp = int(re.search(r"\.bpp\s*=\s*(\d+)", code).group(1))
+    return bitmap, glyphs[1:], line_height, base_line, bpp
+
+
+def glyph_alpha(bitmap, glyph, bpp):
+    """非压缩格式的位图是连续的位流，行之间不补齐"""
+    w, h = glyph["box_w"], glyph["box_h"]
+    start = glyph["bitmap_index"] * 8
+    mask = (1 << bpp) - 1
+    alpha = []
+    for i in range(w * h):
+        bit = start + i * bpp
+        byte = bitmap[bit // 8]
+        v = (byte >> (8 - bpp - bit % 8)) & mask
+        alpha.append(v * 255 // mask)
+    return alpha
+
+
+def to_rgb565(rgb):
+    r, g, b = rgb
+    return (r >> 3, g >> 2, b >> 3)
+
+
+def mix(fg, bg, a):
+    # 与 lv_color_mix 相同，在 RGB565 分量上混合
+    return tuple((f * a + b * (255 - a) + 128) >> 8 for f, b in zip(fg, bg))
+
+
+def render(bitmap, glyph, bpp, cell_w, line_height, base_line, fg, bg):
+    pixels = [bg] * (cell_w * line_height)
+    alpha = glyph_alpha(bitmap, glyph, bpp)
+    # 与 lv_draw_label 的字形位置相同
+    x0 = glyph["ofs_x"]
+    y0 = line_height - base_line - glyph["box_h"] - glyph["ofs_y"]
+    for j in range(glyph["box_h"]):
+        for i in range(glyph["box_w"]):
+            x, y = x0 + i, y0 + j
+            if 0 <= x < cell_w and 0 <= y < line_height:
+                pixels[y * cell_w + x] = mix(fg, bg, alpha[j * glyph["box_w"] + i])
+    return pixels
+
+
+def main():
+    parser = argparse.ArgumentParser(description="生成时钟数字图集")
+    parser.add_argument("--fg", default="ffffff", help="前景色 RRGGBB")
+    parser.add_argument("--bg", default="000000", help="背景色 RRGGBB，与屏幕背景相同")
+    args = parser.parse_args()
+
+    fg = to_rgb565(bytes.fromhex(args.fg))
+    bg = to_rgb565(bytes.fromhex(args.bg))
+
+    bitmap, glyphs, line_height, base_line, bpp = parse_font(FONT_FILE)
+    cell_w = glyphs[0]["adv_w"] // 16  # adv_w 为 1/16 像素
+
+    out = []
+    out.append("/*")
+    out.append(" * 由 scripts/gen_digit_atlas.py 从 lv_font_jetbrainsmono_40.c 生成，不要手动修改")
+    out.append(f" * {cell_w}x{line_height} RGB565，前景 #{args.fg}，背景 #{args.bg}")
+    out.append(" */")
+    out.append("")
+    out.append("#include <lvgl.h>")
+    out.append('#include "fonts/clock_digits_40.h"')
+    out.append("")
+    out.append("#if LV_COLOR_DEPTH != 16 || !LV_COLOR_16_SWAP")
+    out.append('#error "clock digit atlas is generated for RGB565 with LV_COLOR_16_SWAP"')
+    out.append("#endif")
+    out.append("")
+
+    for sym, glyph in zip(SYMBOLS, glyphs):
+        pixels = render(bitmap, glyph, bpp, cell_w, line_height, base_line, fg, bg)
+        data = []
+        for r, g, b in pixels:
+            v = (r << 11) | (g << 5) | b
+            data += [v >> 8, v & 0xFF]  # LV_COLOR_16_SWAP：高字节在前
+        name = "colon" if sym == ":" else sym
+        out.append(f"/* '{sym}' */")
+        out.append(f"static const uint8_t clock_digit_{name}_map[] = {{")
+        for i in range(0, len(data), 16):
+            out.append("    " + ", ".join(f"0x{b:02x}" for b in data[i:i + 16]) + ",")
+        out.append("};")
+        out.append("")
+
+    out.append(f"const lv_img_dsc_t clock_digits_40[CLOCK_DIGITS_40_COUNT] = {{")
+    for sym in SYMBOLS:
+        name = "colon" if sym == ":" else sym
+        out.append("    {")
+        out.append("        .header.cf = LV_IMG_CF_TRUE_COLOR,")
+        out.append("        .header.always_zero = 0,")
+        out.append("        .header.reserved = 0,")
+        out.append(f"        .header.w = {cell_w},")
+        out.append(f"        .header.h = {line_height},")
+        out.append(f"        .data_size = sizeof(clock_digit_{name}_map),")
+        out.append(f"        .data = clock_digit_{name}_map,")
+        out.append("    },")
+    out.append("};")
+
+    with open(OUTPUT_FILE, "w") as f:
+        f.write("\n".join(out) + "\n")
+    print(f"已生成 {OUTPUT_FILE}（{len(SYMBOLS)} 个字符，{cell_w}x{line_height}）")
+
+
+if __name__ == "__main__":
+    main()
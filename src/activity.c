@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/sensor_event.h>
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_ACTIVITY_RECONNECT)
+#include <zmk/events/split_peripheral_status_changed.h>
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_ACTIVITY_POINTER)
+#include <zephyr/input/input.h>
+#endif
+
+#include "activity.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Pointer and encoder events arrive in bursts, one signal per interval is enough for the timers
+#define ACTIVITY_SIGNAL_MIN_INTERVAL_MS 50
+
+static struct k_spinlock lock;
+static int64_t last_wake_ms = 0; // Boot counts as activity
+static uint32_t wake_seq = 0;
+static activity_callback_t callback = NULL;
+
+/* ============================
+ *      Registry
+ * ============================ */
+
+void activity_signal(const struct activity_source *source)
+{
+    if (source->weight == ACTIVITY_HOLD && source->hold_ms == 0) {
+        return; // Source disabled
+    }
+
+    struct activity_source_state *state = source->state;
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    // The first signal of a burst always passes, so waking is never delayed
+    if (state->last_signal_ms != 0 && now - state->last_signal_ms < ACTIVITY_SIGNAL_MIN_INTERVAL_MS) {
+        k_spin_unlock(&lock, key);
+        return;
+    }
+    state->last_signal_ms = now;
+
+    if (source->weight == ACTIVITY_WAKE) {
+        last_wake_ms = now;
+        wake_seq++;
+    }
+    activity_callback_t cb = callback;
+
+    k_spin_unlock(&lock, key);
+
+    LOG_DBG("Activity from %s", source->name);
+
+    if (cb) {
+        cb(source);
+    }
+}
+
+void activity_get(struct activity_snapshot *snapshot)
+{
+    int64_t hold_until_ms = 0;
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    // Every source holds until its own last signal + hold time, the latest of those counts
+    STRUCT_SECTION_FOREACH(activity_source, source) {
+        int64_t last = source->state->last_signal_ms;
+
+        if (last != 0 && last + source->hold_ms > hold_until_ms) {
+            hold_until_ms = last + source->hold_ms;
+        }
+    }
+
+    snapshot->last_wake_ms = last_wake_ms;
+    snapshot->hold_until_ms = hold_until_ms;
+    snapshot->wake_seq = wake_seq;
+
+    k_spin_unlock(&lock, key);
+}
+
+void activity_set_callback(activity_callback_t cb)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    callback = cb;
+    k_spin_unlock(&lock, key);
+}
+
+/* ============================
+ *      ZMK event sources
+ * ============================ */
+
+ACTIVITY_SOURCE_DEFINE(encoder, ACTIVITY_WAKE, 0);
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_ACTIVITY_RECONNECT)
+ACTIVITY_SOURCE_DEFINE(reconnect, ACTIVITY_WAKE, 0);
+#endif
+
+static int activity_listener(const zmk_event_t *eh)
+{
+    if (as_zmk_sensor_event(eh)) {
+        activity_signal(ACTIVITY_SOURCE(encoder));
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_ACTIVITY_RECONNECT)
+    const struct zmk_split_peripheral_status_changed *ev = as_zmk_split_peripheral_status_changed(eh);
+    if (ev && ev->connected) {
+        LOG_INF("Peripheral reconnected, signalling activity");
+        activity_signal(ACTIVITY_SOURCE(reconnect));
+    }
+#endif
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(screen_activity, activity_listener);
+ZMK_SUBSCRIPTION(screen_activity, zmk_sensor_event);
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_ACTIVITY_RECONNECT)
+ZMK_SUBSCRIPTION(screen_activity, zmk_split_peripheral_status_changed);
+#endif
+
+/* ============================
+ *      Input subsystem source
+ * ============================ */
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_ACTIVITY_POINTER)
+
+ACTIVITY_SOURCE_DEFINE(pointer, ACTIVITY_WAKE, 0);
+
+static void activity_input_cb(struct input_event *evt)
+{
+    // Only the last event of a report, a pointer move is several REL events
+    if (evt->sync) {
+        activity_signal(ACTIVITY_SOURCE(pointer));
+    }
+}
+
+INPUT_CALLBACK_DEFINE(NULL, activity_input_cb);
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/sys/util.h>
+
+/**
+ * @brief How a signal affects the screen
+ */
+enum activity_weight {
+    ACTIVITY_HOLD, // Keeps the current level for the source's hold time, never wakes the screen
+    ACTIVITY_WAKE, // Restarts the idle timers and wakes a dimmed or idle-off screen
+};
+
+/**
+ * @brief Per source state, changed by every accepted signal
+ */
+struct activity_source_state {
+    int64_t last_signal_ms; // Uptime of the last accepted signal, 0 before the first one
+};
+
+/**
+ * @brief Something that counts as use of the keyboard for the idle timers
+ * Defined with ACTIVITY_SOURCE_DEFINE by the module that produces the signal.
+ */
+struct activity_source {
+    const char *name;
+    enum activity_weight weight;
+    uint32_t hold_ms; // The screen does not dim or turn off before signal + hold_ms
+    struct activity_source_state *state;
+};
+
+/**
+ * @brief Register an activity source, usage like HID_COMMAND_DEFINE
+ * Can be placed in any module without changing activity.c. A hold source with hold_ms 0
+ * is disabled. Signal it with activity_signal(ACTIVITY_SOURCE(name)).
+ */
+#define ACTIVITY_SOURCE_DEFINE(_name, _weight, _hold_ms)                                           \
+    static struct activity_source_state _CONCAT(activity_source_state_, _name);                    \
+    const STRUCT_SECTION_ITERABLE(activity_source, _CONCAT(activity_source_, _name)) = {           \
+        .name = STRINGIFY(_name),                                                                  \
+        .weight = (_weight),                                                                       \
+        .hold_ms = (_hold_ms),                                                                     \
+        .state = &_CONCAT(activity_source_state_, _name),                                          \
+    }
+
+/**
+ * @brief Source defined with ACTIVITY_SOURCE_DEFINE in the same file
+ */
+#define ACTIVITY_SOURCE(_name) (&_CONCAT(activity_source_, _name))
+
+/**
+ * @brief Activity state for the idle engine
+ * Dim and off deadlines are MAX(last_wake_ms + timeout, hold_until_ms).
+ */
+struct activity_snapshot {
+    int64_t last_wake_ms;  // Uptime of the last wake signal
+    int64_t hold_until_ms; // Latest signal time + hold time over all sources
+    uint32_t wake_seq;     // Incremented by every wake signal
+};
+
+typedef void (*activity_callback_t)(const struct activity_source *source);
+
+/**
+ * @brief Report activity from a source
+ * Cheap enough for every event, repeated signals of a source are rate limited.
+ * Can be called from any thread.
+ */
+void activity_signal(const struct activity_source *source);
+
+/**
+ * @brief Copy the current activity state
+ */
+void activity_get(struct activity_snapshot *snapshot);
+
+/**
+ * @brief Called after every accepted signal, in the context of the signalling thread
+ */
+void activity_set_callback(activity_callback_t callback);
@@ -0,0 +1,400 @@
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <string.h>
+
+#include "assets.h"
+#include "hid_command.h"
+#include "hid_response.h"
+
+LOG_MODULE_REGISTER(assets, LOG_LEVEL_DBG);
+
+ZMK_EVENT_IMPL(dongle_asset_changed);
+
+#define ASSET_PARTITION asset_partition
+#define ASSET_NODE DT_NODELABEL(ASSET_PARTITION)
+
+/* 描述符直接指向映射地址，只支持内部 flash */
+BUILD_ASSERT(DT_SAME_NODE(DT_GPARENT(ASSET_NODE), DT_CHOSEN(zephyr_flash)),
+             "asset_partition must be on the internal flash");
+
+#define ASSET_SLOTS CONFIG_DONGLE_SCREEN_ASSET_SLOTS
+#define ASSET_MAGIC 0x3141444cU  // "LDA1"
+#define ASSET_DATA_OFFSET 32
+#define ASSET_WRITE_BUF_SIZE 64  // flash 写入缓冲，必须是写入对齐的整数倍
+#define ASSET_MAX_DIM 2047       // lv_img_header_t 中宽高只有 11 位
+
+struct asset_header {
+    uint32_t magic;
+    uint32_t size;    // 图片数据字节数
+    uint32_t crc;     // 图片数据 CRC32 (IEEE)
+    uint16_t width;
+    uint16_t height;
+    uint8_t cf;       // lv_img_cf_t
+    uint8_t reserved[ASSET_DATA_OFFSET - 17];
+} __packed;
+
+BUILD_ASSERT(sizeof(struct asset_header) == ASSET_DATA_OFFSET);
+
+static const struct flash_area *fa;
+static size_t page_size;
+static size_t slot_size;  // 页大小的整数倍
+
+static lv_img_dsc_t images[ASSET_SLOTS];
+static bool image_valid[ASSET_SLOTS];
+
+/* 当前上传，RAM 中的状态在 USB/BLE 断开后保留，主机查询 STATUS 后从 offset 继续 */
+static struct {
+    bool active;
+    uint8_t slot;
+    struct asset_header header;  // 提交时写入 flash
+    uint32_t offset;             // 已接收字节数，含写入缓冲中的部分
+    uint32_t crc;                // 已接收数据的 CRC
+    uint32_t erased_end;         // 槽位内已擦除到的偏移
+    uint32_t written;            // 已写入 flash 的数据字节数
+    uint8_t buf[ASSET_WRITE_BUF_SIZE];
+    uint8_t buf_len;
+} upload;
+
+static off_t slot_offset(uint8_t slot)
+{
+    return (off_t)slot * slot_size;
+}
+
+static const uint8_t *slot_mapped(uint8_t slot)
+{
+    return (const uint8_t *)(CONFIG_FLASH_BASE_ADDRESS + fa->fa_off + slot_offset(slot));
+}
+
+/* ============================
+ *      槽位加载
+ * ============================ */
+
+/*
+ * 只接受 LVGL 内置解码器能显示的格式（真彩色、索引色、alpha），且数据至少有
+ * w、h、cf 对应的字节数，否则绘制时会读到槽位之外
+ */
+static bool asset_format_valid(uint8_t cf, uint16_t w, uint16_t h, uint32_t size)
+{
+    if (w == 0 || h == 0 || w > ASSET_MAX_DIM || h > ASSET_MAX_DIM) {
+        return false;
+    }
+
+    uint32_t needed = lv_img_buf_get_img_size(w, h, cf);
+    return needed != 0 && needed <= size;
+}
+
+static void asset_invalidate(uint8_t slot)
+{
+    if (image_valid[slot]) {
+        image_valid[slot] = false;
+        lv_img_cache_invalidate_src(&images[slot]);
+    }
+}
+
+static bool asset_load(uint8_t slot)
+{
+    const struct asset_header *hdr = (const struct asset_header *)slot_mapped(slot);
+
+    if (hdr->magic != ASSET_MAGIC || hdr->size > slot_size - ASSET_DATA_OFFSET) {
+        return false;
+    }
+    if (!asset_format_valid(hdr->cf, hdr->width, hdr->height, hdr->size)) {
+        LOG_WRN("槽位 %u 格式无效: %ux%u cf=%u, %u 字节", slot, hdr->width, hdr->height, hdr->cf,
+                hdr->size);
+        return false;
+    }
+
+    const uint8_t *data = slot_mapped(slot) + ASSET_DATA_OFFSET;
+    if (crc32_ieee(data, hdr->size) != hdr->crc) {
+        LOG_WRN("槽位 %u CRC 错误", slot);
+        return false;
+    }
+
+    images[slot] = (lv_img_dsc_t){
+        .header.always_zero = 0,
+        .header.cf = hdr->cf,
+        .header.w = hdr->width,
+        .header.h = hdr->height,
+        .data_size = hdr->size,
+        .data = data,
+    };
+    image_valid[slot] = true;
+
+    LOG_INF("槽位 %u: %ux%u cf=%u, %u 字节", slot, hdr->width, hdr->height, hdr->cf, hdr->size);
+    return true;
+}
+
+const lv_img_dsc_t *assets_get_image(uint8_t slot)
+{
+    if (slot >= ASSET_SLOTS || !image_valid[slot]) {
+        return NULL;
+    }
+    return &images[slot];
+}
+
+uint8_t assets_slot_count(void)
+{
+    return ASSET_SLOTS;
+}
+
+static int assets_init(void)
+{
+    int err = flash_area_open(FIXED_PARTITION_ID(ASSET_PARTITION), &fa);
+    if (err) {
+        LOG_ERR("无法打开 asset_partition (%d)", err);
+        return err;
+    }
+
+    struct flash_pages_info info;
+    err = flash_get_page_info_by_offs(flash_area_get_device(fa), fa->fa_off, &info);
+    if (err) {
+        return err;
+    }
+    page_size = info.size;
+    slot_size = (fa->fa_size / ASSET_SLOTS) / page_size * page_size;
+
+    if (slot_size == 0 || flash_area_align(fa) > ASSET_WRITE_BUF_SIZE) {
+        LOG_ERR("asset_partition 太小或写入对齐不支持");
+        return -EINVAL;
+    }
+
+    for (uint8_t i = 0; i < ASSET_SLOTS; i++) {
+        asset_load(i);
+    }
+    return 0;
+}
+
+SYS_INIT(assets_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+/* ============================
+ *      flash 写入
+ * ============================ */
+
+/* 按页擦除到 end（槽位内偏移），只擦除即将写入的页，避免一次性长时间阻塞 */
+static int ensure_erased(uint32_t end)
+{
+    while (upload.erased_end < end) {
+        int err = flash_area_erase(fa, slot_offset(upload.slot) + upload.erased_end, page_size);
+        if (err) {
+            return err;
+        }
+        upload.erased_end += page_size;
+    }
+    return 0;
+}
+
+static int flush_buffer(bool final)
+{
+    size_t len = upload.buf_len;
+    if (len == 0) {
+        return 0;
+    }
+
+    /* 最后一块补齐到写入对齐 */
+    if (final) {
+        size_t align = flash_area_align(fa);
+        size_t padded = ROUND_UP(len, align);
+        memset(upload.buf + len, 0xff, padded - len);
+        len = padded;
+    }
+
+    uint32_t off = ASSET_DATA_OFFSET + upload.written;
+    int err = ensure_erased(off + len);
+    if (!err) {
+        err = flash_area_write(fa, slot_offset(upload.slot) + off, upload.buf, len);
+    }
+    if (err) {
+        LOG_ERR("槽位 %u 写入失败 (%d)", upload.slot, err);
+        upload.active = false;
+        return -EIO;
+    }
+
+    upload.written += upload.buf_len;
+    upload.buf_len = 0;
+    return 0;
+}
+
+/* ============================
+ *      HID 命令
+ * ============================ */
+
+static int asset_reply(uint8_t cmd, uint8_t seq, int err, uint8_t slot)
+{
+    uint8_t rsp[22] = {0};
+    uint8_t state = ASSET_STATE_EMPTY;
+    uint32_t offset = 0;
+    const struct asset_header *header = NULL;
+
+    if (upload.active && upload.slot == slot) {
+        state = ASSET_STATE_UPLOADING;
+        offset = upload.offset;
+        header = &upload.header;
+    } else if (slot < ASSET_SLOTS && image_valid[slot]) {
+        state = ASSET_STATE_VALID;
+        offset = images[slot].data_size;
+        header = (const struct asset_header *)slot_mapped(slot);
+    }
+
+    rsp[0] = cmd;
+    rsp[1] = seq;
+    rsp[2] = hid_response_status(err);
+    rsp[3] = slot;
+    rsp[4] = state;
+    sys_put_le32(offset, &rsp[5]);
+
+    /* 主机据此判断槽位中的上传是不是同一个文件，不是就重新 BEGIN */
+    if (header) {
+        sys_put_le32(header->size, &rsp[9]);
+        sys_put_le32(header->crc, &rsp[13]);
+        sys_put_le16(header->width, &rsp[17]);
+        sys_put_le16(header->height, &rsp[19]);
+        rsp[21] = header->cf;
+    }
+
+    hid_response_send(rsp, sizeof(rsp));
+    return err;
+}
+
+static int asset_begin_handler(const uint8_t *payload, uint8_t len)
+{
+    uint8_t seq = payload[0];
+    uint8_t slot = payload[1];
+    uint8_t cf = payload[2];
+    uint16_t width = sys_get_le16(&payload[3]);
+    uint16_t height = sys_get_le16(&payload[5]);
+    uint32_t size = sys_get_le32(&payload[7]);
+
+    if (slot >= ASSET_SLOTS || size == 0 || size > slot_size - ASSET_DATA_OFFSET ||
+        !asset_format_valid(cf, width, height, size)) {
+        return asset_reply(HID_CMD_ASSET_BEGIN, seq, -EINVAL, slot);
+    }
+
+    /* 先让旧图片失效，再擦除首页，之后槽位在提交前一直为空 */
+    asset_invalidate(slot);
+    raise_dongle_asset_changed((struct dongle_asset_changed){.slot = slot, .valid = false});
+
+    upload = (typeof(upload)){
+        .active = true,
+        .slot = slot,
+        .header = {
+            .magic = ASSET_MAGIC,
+            .size = size,
+            .crc = sys_get_le32(&payload[11]),
+            .width = width,
+            .height = height,
+            .cf = cf,
+        },
+    };
+
+    int err = ensure_erased(ASSET_DATA_OFFSET);
+    if (err) {
+        upload.active = false;
+        err = -EIO;
+    }
+
+    LOG_INF("开始上传槽位 %u: %u 字节", slot, size);
+    return asset_reply(HID_CMD_ASSET_BEGIN, seq, err, slot);
+}
+
+HID_COMMAND_DEFINE(asset_begin, HID_CMD_ASSET_BEGIN, 15, asset_begin_handler);
+
+static int asset_chunk_handler(const uint8_t *payload, uint8_t len)
+{
+    uint8_t seq = payload[0];
+    uint32_t offset = sys_get_le32(&payload[1]);
+    uint8_t n = payload[5];
+    const uint8_t *data = &payload[6];
+
+    if (!upload.active) {
+        return asset_reply(HID_CMD_ASSET_CHUNK, seq, -ENODEV, 0xff);
+    }
+
+    /* 重复的块（主机没收到回复而重发）直接确认，要在长度检查之前，否则重发的最后一块会越界 */
+    if (offset + n == upload.offset) {
+        return asset_reply(HID_CMD_ASSET_CHUNK, seq, 0, upload.slot);
+    }
+    if (n > len - 6 || upload.offset + n > upload.header.size) {
+        return asset_reply(HID_CMD_ASSET_CHUNK, seq, -EMSGSIZE, upload.slot);
+    }
+    /* 只接受连续写入，回复中带有期望的偏移 */
+    if (offset != upload.offset) {
+        return asset_reply(HID_CMD_ASSET_CHUNK, seq, -ESPIPE, upload.slot);
+    }
+
+    upload.crc = crc32_ieee_update(upload.crc, data, n);
+    upload.offset += n;
+
+    while (n > 0) {
+        uint8_t take = MIN(n, ASSET_WRITE_BUF_SIZE - upload.buf_len);
+        memcpy(upload.buf + upload.buf_len, data, take);
+        upload.buf_len += take;
+        data += take;
+        n -= take;
+
+        if (upload.buf_len == ASSET_WRITE_BUF_SIZE) {
+            int err = flush_buffer(false);
+            if (err) {
+                return asset_reply(HID_CMD_ASSET_CHUNK, seq, err, upload.slot);
+            }
+        }
+    }
+
+    return asset_reply(HID_CMD_ASSET_CHUNK, seq, 0, upload.slot);
+}
+
+HID_COMMAND_DEFINE(asset_chunk, HID_CMD_ASSET_CHUNK, 6, asset_chunk_handler);
+
+static int asset_commit_handler(const uint8_t *payload, uint8_t len)
+{
+    uint8_t seq = payload[0];
+
+    if (!upload.active) {
+        return asset_reply(HID_CMD_ASSET_COMMIT, seq, -ENODEV, 0xff);
+    }
+
+    uint8_t slot = upload.slot;
+    if (upload.offset != upload.header.size) {
+        return asset_reply(HID_CMD_ASSET_COMMIT, seq, -ESPIPE, slot);
+    }
+
+    int err = flush_buffer(true);
+    if (err) {
+        return asset_reply(HID_CMD_ASSET_COMMIT, seq, err, slot);
+    }
+
+    /* 传输过程中的 CRC 和 flash 回读的 CRC 都必须与主机一致 */
+    const uint8_t *data = slot_mapped(slot) + ASSET_DATA_OFFSET;
+    if (upload.crc != upload.header.crc || crc32_ieee(data, upload.header.size) != upload.header.crc) {
+        LOG_WRN("槽位 %u CRC 不匹配", slot);
+        upload.active = false;
+        return asset_reply(HID_CMD_ASSET_COMMIT, seq, -EBADMSG, slot);
+    }
+
+    err = flash_area_write(fa, slot_offset(slot), &upload.header, sizeof(upload.header));
+    upload.active = false;
+    if (err || !asset_load(slot)) {
+        return asset_reply(HID_CMD_ASSET_COMMIT, seq, -EIO, slot);
+    }
+
+    /* 使用该槽位的 widget 刷新，下次绘制时读到新图片 */
+    raise_dongle_asset_changed((struct dongle_asset_changed){.slot = slot, .valid = true});
+    return asset_reply(HID_CMD_ASSET_COMMIT, seq, 0, slot);
+}
+
+HID_COMMAND_DEFINE(asset_commit, HID_CMD_ASSET_COMMIT, 1, asset_commit_handler);
+
+static int asset_status_handler(const uint8_t *payload, uint8_t len)
+{
+    uint8_t slot = payload[1];
+    int err = slot < ASSET_SLOTS ? 0 : -EINVAL;
+
+    return asset_reply(HID_CMD_ASSET_STATUS, payload[0], err, slot);
+}
+
+HID_COMMAND_DEFINE(asset_status, HID_CMD_ASSET_STATUS, 2, asset_status_handler);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <lvgl.h>
+
+#include <zmk/event_manager.h>
+
+/*
+ * 通过 Raw HID 上传到 asset_partition 的图片
+ *
+ * 分区平均分成 CONFIG_DONGLE_SCREEN_ASSET_SLOTS 个槽位，每个槽位存一张图片：
+ *   [struct asset_header，32 字节][图片数据]
+ * 头部在数据写完并校验 CRC 之后才写入，上传中断的槽位没有有效头部。
+ * 图片描述符直接指向内部 flash 的映射地址，不复制到 RAM。
+ */
+
+/* 上传命令，回复使用与请求相同的 ID */
+#define HID_CMD_ASSET_BEGIN 0xB8   // [seq][slot][cf][w u16][h u16][size u32][crc u32]
+#define HID_CMD_ASSET_CHUNK 0xB9   // [seq][offset u32][n][data * n]
+#define HID_CMD_ASSET_COMMIT 0xBA  // [seq]
+#define HID_CMD_ASSET_STATUS 0xBB  // [seq][slot]
+
+/*
+ * 回复：[cmd][seq][status][slot][state][offset u32][size u32][crc u32][w u16][h u16][cf]
+ * size 之后是正在上传或已有图片的 BEGIN 参数，槽位为空时全为 0
+ */
+enum asset_state {
+    ASSET_STATE_EMPTY = 0,
+    ASSET_STATE_UPLOADING = 1,  // offset 为下一块的期望偏移
+    ASSET_STATE_VALID = 2,      // offset 为图片数据长度
+};
+
+/**
+ * @brief 槽位内容变化
+ *
+ * 上传开始时（valid = false，旧图片已失效）和提交成功后（valid = true）触发。
+ * 在显示工作队列中触发，监听器可以直接操作 LVGL 对象，
+ * 使用该槽位的对象要在这里刷新或改用内置图片。
+ */
+struct dongle_asset_changed {
+    uint8_t slot;
+    bool valid;
+};
+
+ZMK_EVENT_DECLARE(dongle_asset_changed);
+
+/**
+ * @brief 获取槽位中的图片
+ *
+ * 只能在显示工作队列中使用，槽位重新上传时描述符会失效。
+ *
+ * @return 槽位为空或正在上传时返回 NULL
+ */
+const lv_img_dsc_t *assets_get_image(uint8_t slot);
+
+/**
+ * @brief 槽位数量
+ */
+uint8_t assets_slot_count(void);
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/bluetooth/conn.h>
+
+#include <zmk/ble.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/ble_active_profile_changed.h>
+
+#include "ble_bond.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+ZMK_EVENT_IMPL(dongle_ble_bond_state_changed);
+
+static atomic_t bonded_mask = ATOMIC_INIT(0);
+
+uint32_t ble_bond_bonded_mask(void)
+{
+    return atomic_get(&bonded_mask);
+}
+
+/*
+ * Runs on the system work queue, after every Bluetooth callback of the same pairing or
+ * unpairing has returned, so ZMK has already stored or cleared the profile address
+ */
+static void bond_scan_work_handler(struct k_work *work)
+{
+    uint32_t mask = 0;
+
+    for (int i = 0; i < ZMK_BLE_PROFILE_COUNT; i++) {
+        if (!zmk_ble_profile_is_open(i)) {
+            mask |= BIT(i);
+        }
+    }
+
+    if (atomic_set(&bonded_mask, mask) == mask) {
+        return;
+    }
+
+    LOG_DBG("Bonded profiles: 0x%02x", mask);
+    raise_dongle_ble_bond_state_changed(
+        (struct dongle_ble_bond_state_changed){.bonded_mask = mask});
+}
+
+static K_WORK_DEFINE(bond_scan_work, bond_scan_work_handler);
+
+static void pairing_complete(struct bt_conn *conn, bool bonded)
+{
+    k_work_submit(&bond_scan_work);
+}
+
+static void bond_deleted(uint8_t id, const bt_addr_le_t *peer)
+{
+    k_work_submit(&bond_scan_work);
+}
+
+static struct bt_conn_auth_info_cb auth_info_cb = {
+    .pairing_complete = pairing_complete,
+    .bond_deleted = bond_deleted,
+};
+
+// ZMK raises a profile change after loading the bonds from settings and after clearing a profile
+static int bond_profile_listener(const zmk_event_t *eh)
+{
+    k_work_submit(&bond_scan_work);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(ble_bond, bond_profile_listener);
+ZMK_SUBSCRIPTION(ble_bond, zmk_ble_active_profile_changed);
+
+static int ble_bond_init(void)
+{
+    int err = bt_conn_auth_info_cb_register(&auth_info_cb);
+    if (err) {
+        LOG_ERR("Failed to register bond callbacks (%d)", err);
+        return err;
+    }
+
+    k_work_submit(&bond_scan_work);
+    return 0;
+}
+
+SYS_INIT(ble_bond_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
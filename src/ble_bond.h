@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <zmk/event_manager.h>
+
+/**
+ * @brief Raised when the set of bonded BLE profiles changes
+ * ZMK has no bond event, so this module watches pairing, bond deletion and profile changes
+ * and rescans the profiles only then. Bit i is set when profile i has a bond.
+ */
+struct dongle_ble_bond_state_changed {
+    uint32_t bonded_mask;
+};
+
+ZMK_EVENT_DECLARE(dongle_ble_bond_state_changed);
+
+/**
+ * @brief Bonded profiles as of the last scan, same layout as the event
+ * Can be called from any thread.
+ */
+uint32_t ble_bond_bonded_mask(void);
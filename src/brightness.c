@@ -3,16 +3,20 @@
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/drivers/led.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/layer_state_changed.h>
-#include <math.h>
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BRIGHTNESS_PERSIST)
+#include <zephyr/settings/settings.h>
+#endif
 #include <stdlib.h>
 
-int random0to100()
-{
-    return rand() % 101; // 0 to 100
-}
+#include "brightness.h"
+#include "activity.h"
+#include "brightness_calc.h"
+#include "display_power.h"
+#include "hid_command.h"
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -61,167 +65,87 @@ static bool is_dimmed = false;
 #define BRIGHTNESS_DELAY_MS 2
 #define BRIGHTNESS_FADE_DURATION_MS 500
 #define SCREEN_IDLE_TIMEOUT_MS (CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S * 1000)
-#define BRIGHTNESS_CHANGE_THRESHOLD 5
 
 static const struct device *pwm_leds_dev = DEVICE_DT_GET_ONE(pwm_leds);
 #define DISP_BL DT_NODE_CHILD_IDX(DT_NODELABEL(disp_bl))
 
-static int64_t last_activity = 0;
-static uint8_t max_brightness = CONFIG_DONGLE_SCREEN_MAX_BRIGHTNESS;
-static uint8_t min_brightness = CONFIG_DONGLE_SCREEN_MIN_BRIGHTNESS;
 static int8_t current_brightness = CONFIG_DONGLE_SCREEN_DEFAULT_BRIGHTNESS;
 
 static int8_t brightness_modifier = CONFIG_DONGLE_SCREEN_BRIGHTNESS_MODIFIER;
 
 static bool off_through_modifier = false; // Used to track if the screen was turned off through the brightness modifier
 
-/**
- * @brief Structure to hold brightness calculation results
- */
-struct brightness_result
-{
-    uint8_t adjusted_brightness;  // The adjusted base brightness value
-    int8_t adjusted_modifier;     // The adjusted modifier value
-    uint8_t effective_brightness; // Final brightness (adjusted_brightness + adjusted_modifier)
-    bool was_clamped;             // Whether any clamping occurred
-    bool hit_min_limit;           // Whether minimum limit was reached
-    bool hit_max_limit;           // Whether maximum limit was reached
+static const struct brightness_limits limits = {
+    .min = CONFIG_DONGLE_SCREEN_MIN_BRIGHTNESS,
+    .max = CONFIG_DONGLE_SCREEN_MAX_BRIGHTNESS,
 };
 
-static uint8_t clamp_brightness(int8_t value)
+// LED write accounting, one fade is one transition
+static struct brightness_stats stats;
+
+static uint8_t clamp_brightness(int16_t value)
 {
-    if (value > max_brightness)
-    {
-        LOG_WRN("CLAMPED: Screen brightness %d would be over %d", value, max_brightness);
-        return max_brightness;
-    }
-    if (value < min_brightness)
-    {
-        LOG_WRN("CLAMPED: Screen brightness %d would be under %d", value, min_brightness);
-        return min_brightness;
-    }
-    return value;
+    return brightness_clamp(&limits, value);
 }
 
 static void apply_brightness(uint8_t value)
 {
     led_set_brightness(pwm_leds_dev, DISP_BL, value);
+    display_power_note_backlight(value);
+    stats.led_writes++;
     LOG_INF("Screen brightness set to %d", value);
 }
 
 static int8_t calculate_safe_modifier_change(uint8_t base_brightness, int8_t current_modifier, int8_t desired_change)
 {
-    int16_t current_effective = base_brightness + current_modifier;
-    int16_t desired_effective = current_effective + desired_change;
-
-    // Determine the appropriate boundary based on direction of change
-    int16_t boundary = (desired_change > 0) ? max_brightness : min_brightness;
-
-    // Check if the desired change is within bounds
-    if ((desired_change > 0 && desired_effective <= boundary) ||
-        (desired_change < 0 && desired_effective >= boundary))
-    {
-        return desired_change; // Full change is safe
-    }
-
-    // Calculate maximum safe change toward the boundary
-    int16_t safe_change = boundary - current_effective;
-
-    // Ensure we don't return a change in the wrong direction or zero when some change is possible
-    if ((desired_change > 0 && safe_change > 0) || (desired_change < 0 && safe_change < 0))
-    {
-        return (int8_t)safe_change;
-    }
-
-    return 0; // No safe change possible
+    return brightness_safe_modifier_change(&limits, base_brightness, current_modifier, desired_change);
 }
 
 static struct brightness_result calculate_brightness_with_bounds(uint8_t base_brightness, int8_t modifier, bool enforce_ambient_constraints)
 {
-    struct brightness_result result = {0};
-
-    // Start with clamped base brightness
-    result.adjusted_brightness = clamp_brightness(base_brightness);
-    result.adjusted_modifier = modifier;
-
-    // Handle ambient light constraints by adjusting base brightness
-    if (enforce_ambient_constraints)
-    {
-#if CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT
-        int16_t effective = result.adjusted_brightness + result.adjusted_modifier;
-        if (effective <= min_brightness)
-        {
-            // Need to increase base brightness to meet minimum
-            uint8_t needed_increase = min_brightness - effective + 1; // +1 to get above minimum
-            uint8_t old_brightness = result.adjusted_brightness;
-
-            result.adjusted_brightness = clamp_brightness(result.adjusted_brightness + needed_increase);
-            result.was_clamped = true;
-            result.hit_min_limit = true;
-
-            LOG_DBG("Ambient: brightness (%d) + modifier (%d) = %d below min (%d), adjusted brightness by +%d to %d, resulting in %d",
-                    old_brightness, modifier, effective, min_brightness,
-                    result.adjusted_brightness - old_brightness, result.adjusted_brightness,
-                    result.adjusted_brightness + modifier);
-        }
-        else if (effective > max_brightness)
-        {
-            // Need to decrease base brightness to stay within maximum
-            uint8_t needed_decrease = effective - max_brightness;
-            uint8_t old_brightness = result.adjusted_brightness;
-
-            if (result.adjusted_brightness >= needed_decrease)
-            {
-                result.adjusted_brightness -= needed_decrease;
-            }
-            else
-            {
-                result.adjusted_brightness = min_brightness;
-            }
-
-            result.was_clamped = true;
-            result.hit_max_limit = true;
-
-            LOG_DBG("Ambient: brightness (%d) + modifier (%d) = %d above max (%d), adjusted brightness by -%d to %d, resulting in %d",
-                    old_brightness, modifier, effective, max_brightness,
-                    old_brightness - result.adjusted_brightness, result.adjusted_brightness,
-                    result.adjusted_brightness + modifier);
-        }
-#endif
-    }
-
-    // Recalculate effective brightness after any ambient adjustments
-    result.effective_brightness = clamp_brightness(result.adjusted_brightness + result.adjusted_modifier);
-
-    // Final boundary check
-    if (result.effective_brightness <= min_brightness)
-    {
-        result.hit_min_limit = true;
-    }
-    if (result.effective_brightness >= max_brightness)
-    {
-        result.hit_max_limit = true;
-    }
-
-    return result;
+    return brightness_calculate_with_bounds(&limits, base_brightness, modifier,
+                                            enforce_ambient_constraints && IS_ENABLED(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT));
 }
 
 static bool should_screen_turn_off(uint8_t base_brightness, int8_t modifier)
 {
-    return (base_brightness + modifier) < min_brightness;
+    return brightness_should_turn_off(&limits, base_brightness, modifier);
 }
 
 static bool should_screen_turn_on(uint8_t base_brightness, int8_t modifier)
 {
-    return (base_brightness + modifier) > min_brightness;
+    return brightness_should_turn_on(&limits, base_brightness, modifier);
+}
+
+void brightness_get_stats(struct brightness_stats *out)
+{
+    *out = stats;
+}
+
+// HID state record: [effective][base][modifier][screen on][settings flash writes, u32 LE]
+static int brightness_hid_query(uint8_t *out, uint8_t max_len)
+{
+    if (max_len < 8)
+    {
+        return -ENOSPC;
+    }
+    out[0] = clamp_brightness(current_brightness + brightness_modifier);
+    out[1] = current_brightness;
+    out[2] = (uint8_t)brightness_modifier;
+    out[3] = display_power_get_state() < DISPLAY_POWER_OFF;
+    sys_put_le32(brightness_settings_write_count(), &out[4]);
+    return 8;
 }
 
+HID_STATE_DEFINE(brightness, HID_STATE_BRIGHTNESS, brightness_hid_query);
+
 // Threaded fade logic
 // Contains starting and target brightness levels to be animated
 struct fade_request_t
 {
-    uint8_t from; // Starting brightness level
-    uint8_t to;   // Target brightness level
+    uint8_t from;  // Starting brightness level
+    uint8_t to;    // Target brightness level
+    uint8_t power; // Display power state the fade leads into (enum display_power_state)
 };
 
 #define FADE_QUEUE_SIZE 4
@@ -230,19 +154,52 @@ struct fade_request_t
 // It holds up to 4 fade_request_t elements and ensures brightness updates are handled sequentially.
 K_MSGQ_DEFINE(fade_msgq, sizeof(struct fade_request_t), FADE_QUEUE_SIZE, 4);
 
-// Cubic ease-in-out function to smooth the interpolation curve.
-// Provides a natural "S-curve" animation effect: starts slow, accelerates, then slows again.
-// Helps avoid abrupt changes in perceived brightness.
-static float ease_in_out(float t)
+// Applies one fade animation, blocks for its duration
+static void run_fade(struct fade_request_t req)
 {
-    if (t < 0.5f)
-        return 4.0f * t * t * t;
-    float f = -2.0f * t + 2.0f;
-    return 1.0f - (f * f * f) / 2.0f;
+    struct brightness_fade_plan plan;
+    uint32_t writes_before = stats.led_writes;
+
+    if (!brightness_fade_plan(req.from, req.to, &plan))
+    {
+        apply_brightness(req.to);
+    }
+    else
+    {
+        uint8_t last_applied = 255; // Used to prevent redundant LED updates to save performance
+
+        // Interpolate brightness across 'steps' frames using easing
+        for (int i = 0; i <= plan.steps; i++)
+        {
+            uint8_t brightness = brightness_fade_value(req.from, req.to, i, plan.steps);
+
+            // Only send update if brightness actually changed
+            if (brightness != last_applied)
+            {
+                apply_brightness(brightness);
+                last_applied = brightness;
+            }
+
+            k_usleep(plan.delay_us); // Sleep before next step to pace the fade
+        }
+
+        // safeguard to ensure the target value is set at the end
+        if (last_applied != req.to)
+        {
+            apply_brightness(req.to);
+        }
+    }
+
+    stats.transitions++;
+    stats.last_transition_writes = stats.led_writes - writes_before;
+    stats.max_transition_writes = MAX(stats.max_transition_writes, stats.last_transition_writes);
+    LOG_DBG("Fade %d -> %d took %u LED writes", req.from, req.to, stats.last_transition_writes);
 }
 
 // Dedicated thread responsible for handling all fade animations.
 // Receives fade requests from the queue and applies brightness changes over time using easing.
+// It also sequences the display power states around the fade:
+// panel and LVGL are resumed before the backlight comes up and only suspended once it is dark.
 void fade_thread(void)
 {
     struct fade_request_t req;
@@ -252,61 +209,31 @@ void fade_thread(void)
         // Wait indefinitely for the next fade request to arrive in the queue
         if (k_msgq_get(&fade_msgq, &req, K_FOREVER) == 0)
         {
-
-            // Skip animation entirely if brightness difference is too small
-            if (req.from == req.to || abs(req.to - req.from) <= 1)
+            if (req.power < DISPLAY_POWER_OFF)
             {
-                apply_brightness(req.to);
-                continue;
+                display_power_set_state(req.power);
             }
 
-            // Calculate brightness difference and use it to determine number of steps
-            int diff = abs(req.to - req.from);
-            int steps = CLAMP(diff * 2, 6, 32); // More steps for smoother fades over large differences
-
-            // Set total animation time: scale with difference but clamp between 500ms and 1000ms
-            int total_duration_ms = CLAMP(diff * 20, 500, 1000); // 20ms per level as baseline
-            int delay_us = (total_duration_ms * 1000) / steps;   // Delay between steps in microseconds
-
-            uint8_t last_applied = 255; // Used to prevent redundant LED updates to save performance
+            run_fade(req);
 
-            // Interpolate brightness across 'steps' frames using easing
-            for (int i = 0; i <= steps; i++)
+            if (req.power >= DISPLAY_POWER_OFF)
             {
-                float t = (float)i / steps;                                  // Normalized time in [0, 1]
-                float eased = ease_in_out(t);                                // Eased time for smoother progression
-                float interpolated = req.from + (req.to - req.from) * eased; // Interpolated value
-                uint8_t brightness = (uint8_t)(interpolated + 0.5f);         // Rounded to nearest integer
-
-                // Only send update if brightness actually changed
-                if (brightness != last_applied)
-                {
-                    apply_brightness(brightness);
-                    last_applied = brightness;
-                }
-
-                k_usleep(delay_us); // Sleep before next step to pace the fade
-            }
-
-            // safeguard to ensure the target value is set at the end
-            if (last_applied != req.to)
-            {
-                apply_brightness(req.to);
+                display_power_set_state(req.power);
             }
         }
     }
 }
 
-// Launch the fade thread with 768 bytes of stack, medium priority (6)
+// Launch the fade thread with 1024 bytes of stack, medium priority (6)
 // 512 was too small for logging, math (float, int), small loop, few stack-local variables
-// 768 is just a guess, optimization is possible, probably
-K_THREAD_DEFINE(fade_tid, 768, fade_thread, NULL, NULL, NULL, 6, 0, 0);
+// 768 was enough for the fade alone, the display power steps need a bit more
+K_THREAD_DEFINE(fade_tid, 1024, fade_thread, NULL, NULL, NULL, 6, 0, 0);
 
 // Function to submit a brightness fade request
 // Ensures that only the most recent fade request is applied by purging the queue first for changes in between animations
-static void fade_to_brightness(uint8_t from, uint8_t to)
+static void fade_to_brightness(uint8_t from, uint8_t to, enum display_power_state power)
 {
-    struct fade_request_t req = {.from = from, .to = to};
+    struct fade_request_t req = {.from = from, .to = to, .power = power};
     k_msgq_purge(&fade_msgq);                // Clear any pending fades to avoid outdated transitions
     k_msgq_put(&fade_msgq, &req, K_NO_WAIT); // Submit the new fade request without blocking
 }
@@ -317,10 +244,146 @@ void set_screen_brightness(uint8_t value, bool ambient)
 
     uint8_t current_effective = clamp_brightness(current_brightness + brightness_modifier);
 
-    fade_to_brightness(current_effective, result.effective_brightness);
+    fade_to_brightness(current_effective, result.effective_brightness, DISPLAY_POWER_ACTIVE);
     current_brightness = result.adjusted_brightness;
 }
 
+// --- Persistent brightness settings ---
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BRIGHTNESS_PERSIST)
+
+#define BRIGHTNESS_SETTINGS_KEY "dongle_screen/brightness"
+
+// Layout of the value stored in flash
+struct brightness_settings
+{
+    int8_t brightness;    // Base brightness (overwritten by the ambient sensor if enabled)
+    int8_t modifier;      // Keyboard modifier
+    uint32_t write_count; // Number of flash writes so far, used as wear indicator
+};
+
+static struct brightness_settings saved_settings = {
+    .brightness = CONFIG_DONGLE_SCREEN_DEFAULT_BRIGHTNESS,
+    .modifier = CONFIG_DONGLE_SCREEN_BRIGHTNESS_MODIFIER,
+    .write_count = 0,
+};
+static bool settings_restored = false;
+
+static void brightness_save_work_handler(struct k_work *work)
+{
+    // A burst of key presses may have ended where it started, nothing to write then
+    if (saved_settings.brightness == current_brightness && saved_settings.modifier == brightness_modifier)
+    {
+        LOG_DBG("Brightness settings unchanged, skipping flash write");
+        return;
+    }
+
+    struct brightness_settings next = {
+        .brightness = current_brightness,
+        .modifier = brightness_modifier,
+        .write_count = saved_settings.write_count + 1,
+    };
+
+    int rc = settings_save_one(BRIGHTNESS_SETTINGS_KEY, &next, sizeof(next));
+    if (rc < 0)
+    {
+        LOG_ERR("Failed to save brightness settings (%d)", rc);
+        return;
+    }
+
+    saved_settings = next;
+    LOG_INF("Brightness settings saved: brightness %d, modifier %d (write #%u)",
+            next.brightness, next.modifier, next.write_count);
+}
+
+static K_WORK_DELAYABLE_DEFINE(brightness_save_work, brightness_save_work_handler);
+
+// Restarts the debounce window, so only the value after the last key press is written
+static void brightness_schedule_save(void)
+{
+    k_work_reschedule(&brightness_save_work, K_MSEC(CONFIG_DONGLE_SCREEN_BRIGHTNESS_SAVE_DEBOUNCE_MS));
+}
+
+static int brightness_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+    const char *next;
+
+    if (settings_name_steq(name, "brightness", &next) && !next)
+    {
+        if (len != sizeof(saved_settings))
+        {
+            LOG_WRN("Stored brightness settings have unexpected size %zu", len);
+            return -EINVAL;
+        }
+
+        int rc = read_cb(cb_arg, &saved_settings, sizeof(saved_settings));
+        if (rc < 0)
+        {
+            return rc;
+        }
+        settings_restored = true;
+        return 0;
+    }
+
+    return -ENOENT;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(dongle_screen, "dongle_screen", NULL, brightness_settings_set, NULL, NULL);
+
+// Loads the stored values before the backlight is switched on for the first time
+static void brightness_restore_settings(void)
+{
+    int rc = settings_subsys_init();
+    if (rc == 0)
+    {
+        rc = settings_load_subtree("dongle_screen");
+    }
+    if (rc < 0)
+    {
+        LOG_ERR("Failed to load brightness settings (%d)", rc);
+        return;
+    }
+    if (!settings_restored)
+    {
+        LOG_DBG("No stored brightness settings, using Kconfig defaults");
+        return;
+    }
+
+    current_brightness = clamp_brightness(saved_settings.brightness);
+    brightness_modifier = CLAMP(saved_settings.modifier, -99, 99);
+
+    // Never boot into a dark screen because it was turned off through the modifier
+    if (should_screen_turn_off(current_brightness, brightness_modifier))
+    {
+        brightness_modifier = limits.min - current_brightness;
+    }
+    else if (current_brightness + brightness_modifier > limits.max)
+    {
+        brightness_modifier = limits.max - current_brightness;
+    }
+
+    LOG_INF("Restored brightness %d, modifier %d (%u flash writes so far)",
+            current_brightness, brightness_modifier, saved_settings.write_count);
+}
+
+uint32_t brightness_settings_write_count(void)
+{
+    return saved_settings.write_count;
+}
+
+#else
+
+static void brightness_schedule_save(void) {}
+
+static void brightness_restore_settings(void) {}
+
+uint32_t brightness_settings_write_count(void)
+{
+    return 0;
+}
+
+#endif // CONFIG_DONGLE_SCREEN_BRIGHTNESS_PERSIST
+
 #if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0 || CONFIG_DONGLE_SCREEN_BRIGHTNESS_KEYBOARD_CONTROL
 // --- Brightness logic ---
 static bool screen_on = true;
@@ -338,14 +401,14 @@ static void screen_set_on(bool on)
             LOG_DBG("SCREEN TURN ON: Adjusted brightness to ensure screen can turn on: %d", current_brightness);
         }
 
-        fade_to_brightness(0, clamp_brightness(current_brightness + brightness_modifier));
+        fade_to_brightness(0, clamp_brightness(current_brightness + brightness_modifier), DISPLAY_POWER_ACTIVE);
         screen_on = true;
         off_through_modifier = false; // Reset the flag, because the screen is turned on again
         LOG_INF("Screen on (smooth)");
     }
     else if (!on && screen_on)
     {
-        fade_to_brightness(clamp_brightness(current_brightness + brightness_modifier), 0);
+        fade_to_brightness(clamp_brightness(current_brightness + brightness_modifier), 0, DISPLAY_POWER_OFF);
         screen_on = false;
         LOG_INF("Screen off (smooth)");
     }
@@ -361,6 +424,19 @@ static void screen_set_on(bool on)
 
 #if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0
 
+#define IDLE_OFF_TIMEOUT_MS ((int64_t)CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S * 1000)
+#if defined(CONFIG_DONGLE_SCREEN_IDLE_DIM_TIMEOUT_S) && (CONFIG_DONGLE_SCREEN_IDLE_DIM_TIMEOUT_S > 0)
+#define IDLE_DIM_TIMEOUT_MS ((int64_t)CONFIG_DONGLE_SCREEN_IDLE_DIM_TIMEOUT_S * 1000)
+#endif
+
+// Given by every activity signal, the thread sleeps until the next deadline otherwise
+static K_SEM_DEFINE(idle_sem, 0, 1);
+
+static void idle_activity_cb(const struct activity_source *source)
+{
+    k_sem_give(&idle_sem);
+}
+
 void screen_idle_thread(void)
 {
     enum {
@@ -368,129 +444,100 @@ void screen_idle_thread(void)
         STATE_DIMMED,      // 调暗状态
         STATE_OFF          // 关屏状态
     } state = STATE_ACTIVE;
-    
-    static uint8_t original_effective_brightness = 0;
-    static uint8_t original_base_brightness = 0;  // 新增：保存原始基础亮度
+
+    uint8_t original_base_brightness = 0;  // 调暗前的基础亮度
+    uint8_t dim_val = 20;                  // 固定暗度值
+    uint32_t handled_wake_seq = 0;
 
     while (1)
     {
-        if (screen_on || (!screen_on && off_through_modifier))
-        {
-            int64_t now = k_uptime_get();
-            int64_t elapsed_ms = now - last_activity;
-            int64_t off_timeout_ms = (int64_t)CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S * 1000;
+        struct activity_snapshot act;
+        activity_get(&act);
 
-#if defined(CONFIG_DONGLE_SCREEN_IDLE_DIM_TIMEOUT_S) && (CONFIG_DONGLE_SCREEN_IDLE_DIM_TIMEOUT_S > 0)
-            int64_t dim_timeout_ms = (int64_t)CONFIG_DONGLE_SCREEN_IDLE_DIM_TIMEOUT_S * 1000;
-
-            // 根据时间判断应该处于什么状态
-            if (elapsed_ms >= off_timeout_ms) {
-                // 应该关屏
-                if (state != STATE_OFF) {
-                    screen_set_on(false);
-                    state = STATE_OFF;
-                    is_dimmed = false;
-                }
-                k_sleep(K_FOREVER);
-            } 
-            else if (elapsed_ms >= dim_timeout_ms) {
-                // 应该调暗
-                if (state == STATE_ACTIVE) {
-                    // 保存原始值
-                    original_base_brightness = current_brightness;  // 保存基础亮度
-                    original_effective_brightness = clamp_brightness(current_brightness + brightness_modifier);
-                    
-                    // 使用固定暗度值
-                    uint8_t dim_val = 20;  // 固定暗度值
-                    
-                    fade_to_brightness(original_effective_brightness, dim_val);
-                    state = STATE_DIMMED;
-                    is_dimmed = true;
-                    LOG_INF("Idle: Dimming from %d to %d", original_effective_brightness, dim_val);
-                }
-                
-                k_sleep(K_MSEC(100));
-            } 
-            else {
-                // 应该活跃
-                if (state == STATE_DIMMED) {
-                    // 从调暗恢复到活跃
-                    // 恢复原始基础亮度
-                    current_brightness = original_base_brightness;
-                    
-                    // 重新计算有效亮度
-                    uint8_t target_effective = clamp_brightness(current_brightness + brightness_modifier);
-                    
-                    // 从当前暗度渐变到目标亮度
-                    uint8_t dim_val = 20;  // 与调暗时相同的固定值
-                    fade_to_brightness(dim_val, target_effective);
-                    
-                    state = STATE_ACTIVE;
-                    is_dimmed = false;
-                    LOG_INF("Activity: Restoring from %d to %d", dim_val, target_effective);
-                } else if (state == STATE_OFF) {
-                    // 从关屏恢复到活跃
-                    screen_set_on(true);
-                    state = STATE_ACTIVE;
-                    is_dimmed = false;
-                    // 更新原始亮度值
-                    original_effective_brightness = clamp_brightness(current_brightness + brightness_modifier);
-                    original_base_brightness = current_brightness;
-                }
-                
-                int64_t sleep_time = dim_timeout_ms - elapsed_ms;
-                if (sleep_time > 100) {
-                    k_sleep(K_MSEC(100));
-                } else if (sleep_time > 0) {
-                    k_sleep(K_MSEC(sleep_time));
-                } else {
-                    k_sleep(K_MSEC(10));
-                }
-            }
-#else
-            if (elapsed_ms >= off_timeout_ms) {
-                screen_set_on(false);
-                k_sleep(K_FOREVER);
-            } else {
-                int64_t sleep_time = off_timeout_ms - elapsed_ms;
-                if (sleep_time > 100) {
-                    k_sleep(K_MSEC(100));
-                } else if (sleep_time > 0) {
-                    k_sleep(K_MSEC(sleep_time));
-                } else {
-                    k_sleep(K_MSEC(10));
-                }
-            }
-#endif
+        bool woken = act.wake_seq != handled_wake_seq;
+        handled_wake_seq = act.wake_seq;
+
+        // 切换键和亮度调节也会开关屏幕，先同步状态
+        if (screen_on && state == STATE_OFF)
+        {
+            state = STATE_ACTIVE;
         }
-        else {
-            k_sleep(K_FOREVER);
+        else if (!screen_on && state != STATE_OFF)
+        {
+            state = STATE_OFF;
+            is_dimmed = false;
+        }
+
+        // 用户手动关屏：只有切换键或亮度键能重新打开
+        if (off_through_modifier)
+        {
+            k_sem_take(&idle_sem, K_FOREVER);
+            continue;
         }
-    }
-}
 
+        if (woken && state == STATE_DIMMED)
+        {
+            // 从调暗恢复到活跃，恢复原始基础亮度
+            current_brightness = original_base_brightness;
+            uint8_t target_effective = clamp_brightness(current_brightness + brightness_modifier);
+
+            fade_to_brightness(dim_val, target_effective, DISPLAY_POWER_ACTIVE);
+            state = STATE_ACTIVE;
+            is_dimmed = false;
+            LOG_INF("Activity: Restoring from %d to %d", dim_val, target_effective);
+        }
+        else if (woken && state == STATE_OFF)
+        {
+            screen_set_on(true);
+            state = STATE_ACTIVE;
+            is_dimmed = false;
+        }
 
-K_THREAD_DEFINE(screen_idle_tid, 512, screen_idle_thread, NULL, NULL, NULL, 7, 0, 0);
+        // Hold sources (host traffic) push both deadlines out but never wake the screen
+        int64_t now = k_uptime_get();
+        int64_t off_at = MAX(act.last_wake_ms + IDLE_OFF_TIMEOUT_MS, act.hold_until_ms);
+        int64_t next = off_at;
 
-void brightness_wake_screen_on_reconnect(void)
-{
-    if (!screen_on)
-    {
-        LOG_INF("Peripheral reconnected, waking screen");
+        if (state != STATE_OFF && now >= off_at)
+        {
+            screen_set_on(false);
+            state = STATE_OFF;
+            is_dimmed = false;
+        }
+#ifdef IDLE_DIM_TIMEOUT_MS
+        else if (state == STATE_ACTIVE)
+        {
+            int64_t dim_at = MAX(act.last_wake_ms + IDLE_DIM_TIMEOUT_MS, act.hold_until_ms);
 
-        screen_set_on(true);
+            if (now >= dim_at)
+            {
+                original_base_brightness = current_brightness;
+                uint8_t original_effective_brightness = clamp_brightness(current_brightness + brightness_modifier);
 
-        // Reset idle timer
-        last_activity = k_uptime_get();
+                fade_to_brightness(original_effective_brightness, dim_val, DISPLAY_POWER_DIMMED);
+                state = STATE_DIMMED;
+                is_dimmed = true;
+                LOG_INF("Idle: Dimming from %d to %d", original_effective_brightness, dim_val);
+            }
+            else
+            {
+                next = dim_at;
+            }
+        }
+#endif
 
-        k_wakeup(screen_idle_tid);
-    }
-    else
-    {
-        LOG_DBG("Peripheral reconnected but screen already on");
+        // Off waits for the next wake signal, everything else for its deadline or new activity
+        k_timeout_t timeout = K_FOREVER;
+        if (state != STATE_OFF)
+        {
+            timeout = K_MSEC(MAX(next - k_uptime_get(), 0));
+        }
+        k_sem_take(&idle_sem, timeout);
     }
 }
 
+K_THREAD_DEFINE(screen_idle_tid, 512, screen_idle_thread, NULL, NULL, NULL, 7, 0, 0);
+
 #endif
 
 // --- Brightness control via keyboard ---
@@ -508,6 +555,7 @@ static void increase_brightness(void)
         brightness_modifier += safe_increase;
         LOG_DBG("Brightness modifier increased by %d to %d", safe_increase, brightness_modifier);
         set_screen_brightness(current_brightness, false);
+        brightness_schedule_save();
 
         // Check if we should turn screen on
         if (should_screen_turn_on(current_brightness, brightness_modifier) && off_through_modifier)
@@ -533,6 +581,7 @@ static void decrease_brightness(void)
         brightness_modifier += safe_decrease; // Adding a negative value decreases
         LOG_DBG("Brightness modifier decreased by %d to %d", -safe_decrease, brightness_modifier);
         set_screen_brightness(current_brightness, false);
+        brightness_schedule_save();
 
         // Check if we should turn screen off
         if (should_screen_turn_off(current_brightness, brightness_modifier))
@@ -552,8 +601,22 @@ static void decrease_brightness(void)
 
 #if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0 || CONFIG_DONGLE_SCREEN_BRIGHTNESS_KEYBOARD_CONTROL
 
+#if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S == 0
+// Without idle thread: any wake source just turns the screen on
+static void wake_activity_cb(const struct activity_source *source)
+{
+    if (source->weight == ACTIVITY_WAKE && !screen_on)
+    {
+        screen_set_on(true);
+    }
+}
+#endif
+
 // --- Key event listener ---
 
+ACTIVITY_SOURCE_DEFINE(key, ACTIVITY_WAKE, 0); // Brightness keys included once the screen is on
+ACTIVITY_SOURCE_DEFINE(layer, ACTIVITY_WAKE, 0);
+
 static int key_listener(const zmk_event_t *eh)
 {
     const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
@@ -562,17 +625,17 @@ static int key_listener(const zmk_event_t *eh)
         LOG_DBG("Key pressed: keycode=%d", ev->keycode);
 
 #if CONFIG_DONGLE_SCREEN_BRIGHTNESS_KEYBOARD_CONTROL
+        bool handled = true;
+
         if (ev->keycode == CONFIG_DONGLE_SCREEN_BRIGHTNESS_UP_KEYCODE)
         {
             LOG_INF("Brightness UP key recognized!");
             increase_brightness();
-            return 0;
         }
         else if (ev->keycode == CONFIG_DONGLE_SCREEN_BRIGHTNESS_DOWN_KEYCODE)
         {
             LOG_INF("Brightness DOWN key recognized!");
             decrease_brightness();
-            return 0;
         }
         else if (ev->keycode == CONFIG_DONGLE_SCREEN_TOGGLE_KEYCODE)
         {
@@ -587,26 +650,29 @@ static int key_listener(const zmk_event_t *eh)
             {
                 screen_set_on(true);
             }
-            return 0;
+        }
+        else
+        {
+            handled = false;
         }
 
+        if (handled)
+        {
+            // Restart the idle timers only if the key left the screen on, a wake would undo a toggle off
+            if (screen_on)
+            {
+                activity_signal(ACTIVITY_SOURCE(key));
+            }
+            return 0;
+        }
 #endif
+        activity_signal(ACTIVITY_SOURCE(key));
     }
-
-#if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0
-    last_activity = k_uptime_get();
-    if (!screen_on && !off_through_modifier)
-    {
-        screen_set_on(true);
-        k_wakeup(screen_idle_tid);
-    }
-#else
-    // Without idle thread: just turn on screen
-    if (!screen_on)
+    else if (as_zmk_layer_state_changed(eh))
     {
-        screen_set_on(true);
+        activity_signal(ACTIVITY_SOURCE(layer));
     }
-#endif
+
     return 0;
 }
 
@@ -625,92 +691,254 @@ static const struct device *ambient_sensor = DEVICE_DT_GET(AMBIENT_LIGHT_SENSOR_
 const int32_t min_sensor = CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE;
 const int32_t max_sensor = CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE;
 
+#define AMBIENT_FILTER_SHIFT CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_FILTER_SHIFT
+#define AMBIENT_HYSTERESIS CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_HYSTERESIS
+#define AMBIENT_BASE_INTERVAL_MS CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_EVALUATION_INTERVAL_MS
+#define AMBIENT_MAX_INTERVAL_MS MAX(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MAX_INTERVAL_MS, AMBIENT_BASE_INTERVAL_MS)
+
+// Fixed point fraction bits of the filtered sensor value
+#define AMBIENT_FIXED_SHIFT 4
+
 static uint8_t ambient_to_brightness(int32_t sensor_value)
 {
     if (sensor_value < min_sensor)
     {
-        LOG_INF("Ambient sensor reading (%d) below DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE: (%d) Will set the sensor reading to the minimum configured.", sensor_value, CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE);
+        LOG_DBG("Ambient sensor reading (%d) below DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE: (%d) Will set the sensor reading to the minimum configured.", sensor_value, CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE);
         sensor_value = min_sensor;
     }
 
     if (sensor_value > max_sensor)
     {
-        LOG_INF("Ambient sensor reading (%d) above DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE: (%d) Will set the sensor reading to the maximum configured.", sensor_value, CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE);
+        LOG_DBG("Ambient sensor reading (%d) above DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE: (%d) Will set the sensor reading to the maximum configured.", sensor_value, CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE);
         sensor_value = max_sensor;
     }
 
-    uint8_t brightness = min_brightness +
-                         ((sensor_value - min_sensor) * (max_brightness - min_brightness)) /
+    uint8_t brightness = limits.min +
+                         ((sensor_value - min_sensor) * (limits.max - limits.min)) /
                              (max_sensor - min_sensor);
     return clamp_brightness(brightness);
 }
 
-static void ambient_light_thread(void)
+// Exponential moving average in fixed point: f += (x - f) / 2^AMBIENT_FILTER_SHIFT
+// Suppresses flicker from room lights and short shadows before the value reaches the hysteresis.
+static int32_t ambient_filter(int32_t filtered, int32_t raw, bool first)
 {
-    struct sensor_value val;
-    uint8_t last_brightness = 0xFF; // Invalid initial value to force first update
+    int32_t sample = raw << AMBIENT_FIXED_SHIFT;
 
-    while (1)
+    if (first)
+    {
+        return sample;
+    }
+    return filtered + ((sample - filtered) >> AMBIENT_FILTER_SHIFT);
+}
+
+// Width of the raw sensor window that corresponds to the brightness hysteresis
+static int32_t ambient_raw_band(void)
+{
+    int32_t band = (AMBIENT_HYSTERESIS * (max_sensor - min_sensor)) / MAX(limits.max - limits.min, 1);
+    return MAX(band, 1);
+}
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TRIGGER) && !IS_ENABLED(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TEST)
+
+K_SEM_DEFINE(ambient_trigger_sem, 0, 1);
+
+static bool ambient_trigger_armed = false;
+
+static void ambient_trigger_handler(const struct device *dev, const struct sensor_trigger *trig)
+{
+    k_sem_give(&ambient_trigger_sem);
+}
+
+// Moves the sensor's threshold window around the current reading.
+// Returns false if the sensor does not support light thresholds, polling is used then.
+static bool ambient_arm_threshold(int32_t raw)
+{
+    static const struct sensor_trigger trig = {
+        .type = SENSOR_TRIG_THRESHOLD,
+        .chan = SENSOR_CHAN_LIGHT,
+    };
+    int32_t band = ambient_raw_band();
+    struct sensor_value lower = {.val1 = MAX(raw - band, 0)};
+    struct sensor_value upper = {.val1 = raw + band};
+
+    if (sensor_attr_set(ambient_sensor, SENSOR_CHAN_LIGHT, SENSOR_ATTR_LOWER_THRESH, &lower) < 0 ||
+        sensor_attr_set(ambient_sensor, SENSOR_CHAN_LIGHT, SENSOR_ATTR_UPPER_THRESH, &upper) < 0)
+    {
+        return false;
+    }
+
+    if (!ambient_trigger_armed)
+    {
+        int rc = sensor_trigger_set(ambient_sensor, &trig, ambient_trigger_handler);
+        if (rc < 0)
+        {
+            LOG_INF("Ambient light sensor has no threshold trigger (%d), polling instead", rc);
+            return false;
+        }
+        ambient_trigger_armed = true;
+        LOG_INF("Ambient light threshold trigger armed");
+    }
+
+    LOG_DBG("Ambient threshold window %d..%d", lower.val1, upper.val1);
+    return true;
+}
+
+// Sleeps until the sensor signals a threshold crossing or the interval expires
+static void ambient_wait(int32_t interval_ms, bool armed)
+{
+    if (armed)
     {
+        k_sem_take(&ambient_trigger_sem, K_MSEC(interval_ms));
+    }
+    else
+    {
+        k_sleep(K_MSEC(interval_ms));
+        k_sem_reset(&ambient_trigger_sem); // Stale crossings from an outdated window
+    }
+}
+
+#else
+
+static bool ambient_arm_threshold(int32_t raw)
+{
+    return false;
+}
 
+static void ambient_wait(int32_t interval_ms, bool armed)
+{
+    k_sleep(K_MSEC(interval_ms));
+}
+
+#endif // CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TRIGGER
+
+static int ambient_read_raw(int32_t *raw)
+{
 #ifndef CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TEST
+    struct sensor_value val;
+
+    if (!device_is_ready(ambient_sensor))
+    {
+        LOG_ERR("Ambient light sensor not ready!");
+        return -ENODEV;
+    }
+
+    int rc = sensor_sample_fetch(ambient_sensor);
+    if (rc == 0)
+    {
+        rc = sensor_channel_get(ambient_sensor, SENSOR_CHAN_LIGHT, &val);
+    }
+    if (rc == 0)
+    {
+        *raw = val.val1;
+    }
+    return rc;
+#else
+    // Scripted readings instead of rand(): a slow ramp, flicker around one level and a jump,
+    // so filter, hysteresis and backoff behave the same on every run
+    static const uint8_t script[] = {
+        0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100,
+        55, 45, 55, 45, 55, 45, 55, 45,
+        100, 100, 100, 100, 0, 0, 0, 0,
+    };
+    static size_t script_pos = 0;
+
+    *raw = min_sensor + (script[script_pos] * (max_sensor - min_sensor)) / 100;
+    script_pos = (script_pos + 1) % ARRAY_SIZE(script);
+    return 0;
+#endif // CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TEST
+}
+
+static void apply_ambient_brightness(uint8_t new_brightness, int32_t raw)
+{
+    struct brightness_result result = calculate_brightness_with_bounds(new_brightness, brightness_modifier, true);
+
+    LOG_DBG("Ambient light: %d (filtered raw) -> brightness %d, effective (incl. modifier) %d",
+            raw, result.adjusted_brightness, result.effective_brightness);
 
-        if (!device_is_ready(ambient_sensor))
+    if (result.hit_min_limit)
+    {
+        LOG_DBG("Ambient brightness at minimum limit");
+    }
+    if (result.hit_max_limit)
+    {
+        LOG_DBG("Ambient brightness at maximum limit");
+    }
+
+    if (screen_on)
+    {
+        set_screen_brightness(new_brightness, true);
+    }
+    else
+    {
+        // If the screen is off, just set the brightness variable
+        // to have the current ambient brightness when the screen is turned on again
+        current_brightness = result.adjusted_brightness;
+    }
+}
+
+// Sampling pipeline: raw reading -> EMA -> brightness mapping -> hysteresis.
+// The sample interval doubles for every stable reading and snaps back to the base
+// interval as soon as the light changes, so a steady room costs almost no wakeups.
+static void ambient_light_thread(void)
+{
+    int32_t filtered = 0;
+    bool have_sample = false;
+    uint8_t last_brightness = 0xFF; // Invalid initial value to force first update
+    uint8_t last_filtered_brightness = 0xFF;
+    int32_t interval_ms = AMBIENT_BASE_INTERVAL_MS;
+    bool armed = false;
+
+    while (1)
+    {
+        int32_t raw;
+        if (ambient_read_raw(&raw) != 0)
         {
-            LOG_ERR("Ambient light sensor not ready!");
+            have_sample = false;
             k_sleep(K_SECONDS(5));
             continue;
         }
-        int rc = sensor_sample_fetch(ambient_sensor);
-        if (rc == 0)
+
+        filtered = ambient_filter(filtered, raw, !have_sample);
+        have_sample = true;
+
+        int32_t filtered_raw = filtered >> AMBIENT_FIXED_SHIFT;
+        uint8_t new_brightness = ambient_to_brightness(filtered_raw);
+
+        if (last_brightness == 0xFF || abs(new_brightness - last_brightness) > AMBIENT_HYSTERESIS)
         {
-            rc = sensor_channel_get(ambient_sensor, SENSOR_CHAN_LIGHT, &val);
-            if (rc == 0)
-            {
-#else
-        k_sleep(K_SECONDS(10));
-        val.val1 = random0to100();
+            apply_ambient_brightness(new_brightness, filtered_raw);
+            last_brightness = new_brightness;
+        }
 
-#endif
-                uint8_t new_brightness = ambient_to_brightness(val.val1);
-
-                if (abs(new_brightness - last_brightness) > BRIGHTNESS_CHANGE_THRESHOLD)
-                {
-                    struct brightness_result result = calculate_brightness_with_bounds(new_brightness, brightness_modifier, true);
-
-                    LOG_DBG("Ambient light: %d (raw) -> brightness %d, effective (incl. modifier) %d",
-                            val.val1, result.adjusted_brightness, result.effective_brightness);
-
-                    if (result.hit_min_limit)
-                    {
-                        LOG_DBG("Ambient brightness at minimum limit");
-                    }
-                    if (result.hit_max_limit)
-                    {
-                        LOG_DBG("Ambient brightness at maximum limit");
-                    }
-
-                    if (screen_on)
-                    {
-                        set_screen_brightness(new_brightness, true);
-                    }
-                    else
-                    {
-                        // If the screen is off, just set the brightness variable
-                        // to have the current ambient brightness when the screen is turned on again
-                        current_brightness = result.adjusted_brightness;
-                    }
-                    last_brightness = new_brightness;
-                }
-#ifndef CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TEST
-            }
+        // Adaptive interval: the filter is still settling while the filtered value moves
+        if (last_filtered_brightness != 0xFF && abs(new_brightness - last_filtered_brightness) <= 1)
+        {
+            interval_ms = MIN(interval_ms * 2, AMBIENT_MAX_INTERVAL_MS);
+        }
+        else
+        {
+            interval_ms = AMBIENT_BASE_INTERVAL_MS;
         }
-#endif                                                                              // CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TEST
-        k_sleep(K_MSEC(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_EVALUATION_INTERVAL_MS)); // Adjust interval as needed
+        last_filtered_brightness = new_brightness;
+
+        // Once the filter has settled let the sensor interrupt wake us on a real change
+        if (interval_ms == AMBIENT_MAX_INTERVAL_MS)
+        {
+            armed = ambient_arm_threshold(filtered_raw);
+        }
+        else
+        {
+            armed = false;
+        }
+
+        LOG_DBG("Ambient next evaluation in %d ms (%s)", interval_ms, armed ? "threshold armed" : "polling");
+
+        ambient_wait(interval_ms, armed);
     }
 }
 
-K_THREAD_DEFINE(ambient_light_tid, 512, ambient_light_thread, NULL, NULL, NULL, 7, 0, 0);
+K_THREAD_DEFINE(ambient_light_tid, 768, ambient_light_thread, NULL, NULL, NULL, 7, 0, 0);
 
 #endif // CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT
 
@@ -718,13 +946,16 @@ K_THREAD_DEFINE(ambient_light_tid, 512, ambient_light_thread, NULL, NULL, NULL,
 
 static int init_fixed_brightness(void)
 {
+    brightness_restore_settings();
     set_screen_brightness(current_brightness, false);
-    last_activity = k_uptime_get();
 #if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0
-    // Wake up the idle thread at boot
-    k_wakeup(screen_idle_tid);
+    activity_set_callback(idle_activity_cb);
+    k_sem_give(&idle_sem);
 #else
     LOG_INF("Screen idle timeout disabled");
+#if CONFIG_DONGLE_SCREEN_BRIGHTNESS_KEYBOARD_CONTROL
+    activity_set_callback(wake_activity_cb);
+#endif
 #endif
     return 0;
 }
@@ -6,8 +6,25 @@
 
 #pragma once
 
+#include <stdint.h>
+
+/**
+ * @brief Number of flash writes done for the persisted brightness settings
+ * Stays 0 if CONFIG_DONGLE_SCREEN_BRIGHTNESS_PERSIST is disabled
+ */
+uint32_t brightness_settings_write_count(void);
+
+/**
+ * @brief Backlight write statistics, one transition is one fade request
+ */
+struct brightness_stats {
+    uint32_t transitions;            // Fades run since boot
+    uint32_t led_writes;             // led_set_brightness calls since boot
+    uint32_t last_transition_writes; // LED writes of the last fade
+    uint32_t max_transition_writes;  // Most LED writes a single fade needed
+};
+
 /**
- * @brief Wake the screen when a peripheral reconnects
- * Called by battery widget when it detects a peripheral reconnection
+ * @brief Copy the backlight write statistics
  */
-void brightness_wake_screen_on_reconnect(void);
\ No newline at end of file
+void brightness_get_stats(struct brightness_stats *stats);
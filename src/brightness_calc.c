@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <stdlib.h>
+
+#include "brightness_calc.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+uint8_t brightness_clamp(const struct brightness_limits *limits, int16_t value)
+{
+    if (value > limits->max)
+    {
+        LOG_WRN("CLAMPED: Screen brightness %d would be over %d", value, limits->max);
+        return limits->max;
+    }
+    if (value < limits->min)
+    {
+        LOG_WRN("CLAMPED: Screen brightness %d would be under %d", value, limits->min);
+        return limits->min;
+    }
+    return value;
+}
+
+int8_t brightness_safe_modifier_change(const struct brightness_limits *limits, uint8_t base_brightness,
+                                       int8_t current_modifier, int8_t desired_change)
+{
+    int16_t current_effective = base_brightness + current_modifier;
+    int16_t desired_effective = current_effective + desired_change;
+
+    // Determine the appropriate boundary based on direction of change
+    int16_t boundary = (desired_change > 0) ? limits->max : limits->min;
+
+    // Check if the desired change is within bounds
+    if ((desired_change > 0 && desired_effective <= boundary) ||
+        (desired_change < 0 && desired_effective >= boundary))
+    {
+        return desired_change; // Full change is safe
+    }
+
+    // Calculate maximum safe change toward the boundary
+    int16_t safe_change = boundary - current_effective;
+
+    // Ensure we don't return a change in the wrong direction or zero when some change is possible
+    if ((desired_change > 0 && safe_change > 0) || (desired_change < 0 && safe_change < 0))
+    {
+        return (int8_t)safe_change;
+    }
+
+    return 0; // No safe change possible
+}
+
+struct brightness_result brightness_calculate_with_bounds(const struct brightness_limits *limits,
+                                                          uint8_t base_brightness, int8_t modifier,
+                                                          bool enforce_ambient_constraints)
+{
+    struct brightness_result result = {0};
+
+    // Start with clamped base brightness
+    result.adjusted_brightness = brightness_clamp(limits, base_brightness);
+    result.adjusted_modifier = modifier;
+
+    // Handle ambient light constraints by adjusting base brightness
+    if (enforce_ambient_constraints)
+    {
+        int16_t effective = result.adjusted_brightness + result.adjusted_modifier;
+        if (effective <= limits->min)
+        {
+            // Need to increase base brightness to meet minimum
+            uint8_t needed_increase = limits->min - effective + 1; // +1 to get above minimum
+            uint8_t old_brightness = result.adjusted_brightness;
+
+            result.adjusted_brightness = brightness_clamp(limits, result.adjusted_brightness + needed_increase);
+            result.was_clamped = true;
+            result.hit_min_limit = true;
+
+            LOG_DBG("Ambient: brightness (%d) + modifier (%d) = %d below min (%d), adjusted brightness by +%d to %d, resulting in %d",
+                    old_brightness, modifier, effective, limits->min,
+                    result.adjusted_brightness - old_brightness, result.adjusted_brightness,
+                    result.adjusted_brightness + modifier);
+        }
+        else if (effective > limits->max)
+        {
+            // Need to decrease base brightness to stay within maximum
+            uint8_t needed_decrease = effective - limits->max;
+            uint8_t old_brightness = result.adjusted_brightness;
+
+            if (result.adjusted_brightness >= needed_decrease)
+            {
+                result.adjusted_brightness -= needed_decrease;
+            }
+            else
+            {
+                result.adjusted_brightness = limits->min;
+            }
+
+            result.was_clamped = true;
+            result.hit_max_limit = true;
+
+            LOG_DBG("Ambient: brightness (%d) + modifier (%d) = %d above max (%d), adjusted brightness by -%d to %d, resulting in %d",
+                    old_brightness, modifier, effective, limits->max,
+                    old_brightness - result.adjusted_brightness, result.adjusted_brightness,
+                    result.adjusted_brightness + modifier);
+        }
+    }
+
+    // Recalculate effective brightness after any ambient adjustments
+    result.effective_brightness = brightness_clamp(limits, result.adjusted_brightness + result.adjusted_modifier);
+
+    // Final boundary check
+    if (result.effective_brightness <= limits->min)
+    {
+        result.hit_min_limit = true;
+    }
+    if (result.effective_brightness >= limits->max)
+    {
+        result.hit_max_limit = true;
+    }
+
+    return result;
+}
+
+bool brightness_should_turn_off(const struct brightness_limits *limits, uint8_t base_brightness, int8_t modifier)
+{
+    return (base_brightness + modifier) < limits->min;
+}
+
+bool brightness_should_turn_on(const struct brightness_limits *limits, uint8_t base_brightness, int8_t modifier)
+{
+    return (base_brightness + modifier) > limits->min;
+}
+
+// Cubic ease-in-out function to smooth the interpolation curve.
+// Provides a natural "S-curve" animation effect: starts slow, accelerates, then slows again.
+// Helps avoid abrupt changes in perceived brightness.
+static float ease_in_out(float t)
+{
+    if (t < 0.5f)
+        return 4.0f * t * t * t;
+    float f = -2.0f * t + 2.0f;
+    return 1.0f - (f * f * f) / 2.0f;
+}
+
+bool brightness_fade_plan(uint8_t from, uint8_t to, struct brightness_fade_plan *plan)
+{
+    // Skip animation entirely if brightness difference is too small
+    if (from == to || abs(to - from) <= 1)
+    {
+        return false;
+    }
+
+    // Calculate brightness difference and use it to determine number of steps
+    int diff = abs(to - from);
+    plan->steps = CLAMP(diff * 2, 6, 32); // More steps for smoother fades over large differences
+
+    // Set total animation time: scale with difference but clamp between 500ms and 1000ms
+    int total_duration_ms = CLAMP(diff * 20, 500, 1000);     // 20ms per level as baseline
+    plan->delay_us = (total_duration_ms * 1000) / plan->steps; // Delay between steps in microseconds
+
+    return true;
+}
+
+uint8_t brightness_fade_value(uint8_t from, uint8_t to, int step, int steps)
+{
+    float t = (float)step / steps;                   // Normalized time in [0, 1]
+    float eased = ease_in_out(t);                    // Eased time for smoother progression
+    float interpolated = from + (to - from) * eased; // Interpolated value
+    return (uint8_t)(interpolated + 0.5f);           // Rounded to nearest integer
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Pure brightness math used by brightness.c.
+ * No threads, timers or devices in here, so every function can be run on the host
+ * with the limits passed in explicitly.
+ */
+
+/**
+ * @brief Brightness range all calculations are bounded by
+ */
+struct brightness_limits
+{
+    uint8_t min;
+    uint8_t max;
+};
+
+/**
+ * @brief Structure to hold brightness calculation results
+ */
+struct brightness_result
+{
+    uint8_t adjusted_brightness;  // The adjusted base brightness value
+    int8_t adjusted_modifier;     // The adjusted modifier value
+    uint8_t effective_brightness; // Final brightness (adjusted_brightness + adjusted_modifier)
+    bool was_clamped;             // Whether any clamping occurred
+    bool hit_min_limit;           // Whether minimum limit was reached
+    bool hit_max_limit;           // Whether maximum limit was reached
+};
+
+/**
+ * @brief Step plan of a fade animation
+ */
+struct brightness_fade_plan
+{
+    int steps;    // Number of interpolation steps, the fade applies steps + 1 values
+    int delay_us; // Delay between two steps
+};
+
+uint8_t brightness_clamp(const struct brightness_limits *limits, int16_t value);
+
+/**
+ * @brief Largest part of desired_change that keeps base + modifier inside the limits
+ */
+int8_t brightness_safe_modifier_change(const struct brightness_limits *limits, uint8_t base_brightness,
+                                       int8_t current_modifier, int8_t desired_change);
+
+/**
+ * @brief Bound base brightness and modifier
+ * With enforce_ambient_constraints the base brightness is moved so that base + modifier stays
+ * inside the limits, otherwise only the effective value is clamped.
+ */
+struct brightness_result brightness_calculate_with_bounds(const struct brightness_limits *limits,
+                                                          uint8_t base_brightness, int8_t modifier,
+                                                          bool enforce_ambient_constraints);
+
+bool brightness_should_turn_off(const struct brightness_limits *limits, uint8_t base_brightness, int8_t modifier);
+
+bool brightness_should_turn_on(const struct brightness_limits *limits, uint8_t base_brightness, int8_t modifier);
+
+/**
+ * @brief Plan a fade from one level to another
+ * @return false if the difference is too small to animate, the target should be applied directly
+ */
+bool brightness_fade_plan(uint8_t from, uint8_t to, struct brightness_fade_plan *plan);
+
+/**
+ * @brief Eased brightness value of a fade at the given step (0..steps)
+ */
+uint8_t brightness_fade_value(uint8_t from, uint8_t to, int step, int steps);
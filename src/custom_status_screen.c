@@ -2,7 +2,10 @@
 #include <lvgl.h>
 #include <zephyr/logging/log.h>
 
+#include <zmk/display.h>
+
 #include "raw_hid_bridge.h"
+#include "hid_command.h"
 #include "widgets/clock.h"
 #include "widgets/volume.h"
 #include "widgets/battery.h"
@@ -11,15 +14,10 @@
 #include "widgets/bongo_cat.h"
 #include "widgets/sysicon.h"
 #include "widgets/modifiers.h"
+#include "widgets/host_canvas.h"
 
 LOG_MODULE_REGISTER(custom_status_screen, LOG_LEVEL_DBG);
 
-#define HID_UPDATE_PERIOD_MS 50  // 每50ms更新一次
-
-// 同步阈值（秒），当 HID 时间与本地时间差 <= 该值时不进行同步
-#define CLOCK_SYNC_THRESHOLD_S 30
-
-static struct k_timer hid_timer;
 static struct k_work hid_work;
 
 // Widgets
@@ -31,61 +29,34 @@ static struct zmk_widget_connection connection_widget;
 static struct zmk_widget_bongo_cat bongo_cat_widget;
 static struct zmk_widget_sysicon sysicon_widget;
 static struct zmk_widget_modifiers modifiers_widget;
-
-uint8_t system_type = 0;  // 定义并初始化为0（未设置） sysicon.h
-
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_HOST_CANVAS)
+static struct zmk_widget_host_canvas host_canvas_widget;
+#endif
 
 /* ============================
  *      HID 工作函数
  * ============================ */
 static void hid_work_handler(struct k_work *work) {
-    const uint8_t *buf = raw_hid_bridge_get_buffer();
+    const struct raw_hid_report *report;
 
-    // 没有新 HID 数据
-    if (!buf) {
-        //LOG_DBG("No HID data");
-        return;
-    }
-    LOG_DBG("Processing HID cmd=%d", buf[0]);
-
-    switch (buf[0]) {
-        case 170:  // 时间命令：buf[1]=hour, buf[2]=min, buf[3]=sec
-            if (CONFIG_RAW_HID_REPORT_SIZE >= 4) {
-                zmk_widget_clock_sync(&clock_widget, buf[1], buf[2], buf[3], CLOCK_SYNC_THRESHOLD_S);
-            }
-            break;
-
-        case 171:  // 音量命令：buf[1]=volume
-            if (CONFIG_RAW_HID_REPORT_SIZE >= 2) {
-                zmk_widget_volume_set(&volume_widget, buf[1]);
-            }
-            break;
-
-        case 173:  // 系统类型命令：buf[1]=系统类型 (1=Windows, 2=Linux, 3=macOS)
-            if (CONFIG_RAW_HID_REPORT_SIZE >= 2) {
-                // 保存系统类型到全局变量，供其他模块使用
-                system_type = buf[1];
-                LOG_DBG("System type updated: %d", system_type);
-                
-                // 更新系统图标显示（转换为枚举类型）
-                zmk_widget_sysicon_set_system(&sysicon_widget, (enum system_type)system_type);
-
-                // 更新修饰键widget的系统类型
-                zmk_widget_modifiers_set_system_type((enum system_type)system_type);
-            }
-            break;
-
-        default:
-            // 预留用于扩展
-            break;
+    // 处理队列中所有报告，按接收顺序执行；命令由各 widget 通过 HID_COMMAND_DEFINE 注册
+    while ((report = raw_hid_bridge_peek()) != NULL) {
+        hid_command_dispatch(report->data, report->length);
+        raw_hid_bridge_pop();
     }
+
+    struct raw_hid_bridge_stats stats;
+    raw_hid_bridge_get_stats(&stats);
+    LOG_DBG("HID latency %u us (max %u, avg %u)", stats.latency_last_us, stats.latency_max_us,
+            stats.latency_avg_us);
 }
 
 /* ============================
- *     定时器回调
+ *     新报告通知
  * ============================ */
-static void hid_timer_handler(struct k_timer *timer_id) {
-    k_work_submit(&hid_work);
+// 控件只能在显示工作队列中更新；工作已排队时再次提交无效果，多条报告合并处理
+static void hid_report_notify(void) {
+    k_work_submit_to_queue(zmk_display_work_q(), &hid_work);
 }
 
 /* ============================
@@ -146,12 +117,20 @@ lv_obj_t *zmk_display_status_screen(void) {
     lv_obj_align(zmk_widget_battery_bar_obj(&battery_widget), LV_ALIGN_BOTTOM_MID, 0, -8);
     
 
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_HOST_CANVAS)
+    /* ---- 初始化主机画布（最后创建，显示时覆盖在其他 widget 上面）---- */
+    zmk_widget_host_canvas_init(&host_canvas_widget, screen);
+    lv_obj_align(zmk_widget_host_canvas_obj(&host_canvas_widget), LV_ALIGN_CENTER, 0, 0);
+#endif
+
+
     LOG_INF("屏幕和 widgets 已创建");
 
-    /* ---- 启动 HID 处理定时器 ---- */
+    /* ---- 注册 HID 报告通知 ---- */
     k_work_init(&hid_work, hid_work_handler);
-    k_timer_init(&hid_timer, hid_timer_handler, NULL);
-    k_timer_start(&hid_timer, K_MSEC(HID_UPDATE_PERIOD_MS), K_MSEC(HID_UPDATE_PERIOD_MS));
+    raw_hid_bridge_set_notify(hid_report_notify);
+    // 屏幕创建前到达的报告
+    hid_report_notify();
 
     return screen;
 }
\ No newline at end of file
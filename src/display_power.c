@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <lvgl.h>
+
+#include <zmk/display.h>
+
+#include "display_power.h"
+#include "hid_command.h"
+
+LOG_MODULE_REGISTER(display_power, CONFIG_ZMK_LOG_LEVEL);
+
+#define DISPLAY_NODE DT_CHOSEN(zephyr_display)
+
+static const struct device *display_dev = DEVICE_DT_GET(DISPLAY_NODE);
+// The panel is the only device on this bus, so the bus can sleep with it
+static const struct device *display_bus = DEVICE_DT_GET(DT_BUS(DISPLAY_NODE));
+static const struct device *backlight_pwm = DEVICE_DT_GET(DT_PWMS_CTLR(DT_NODELABEL(disp_bl)));
+
+static const char *const state_names[DISPLAY_POWER_STATE_COUNT] = {
+    "active",
+    "dimmed",
+    "off",
+    "deep-off",
+};
+
+// Panel current per state, the backlight share is added from the PWM level
+static const uint32_t panel_ua[DISPLAY_POWER_STATE_COUNT] = {
+    CONFIG_DONGLE_SCREEN_POWER_PANEL_ACTIVE_UA,
+    CONFIG_DONGLE_SCREEN_POWER_PANEL_ACTIVE_UA,
+    CONFIG_DONGLE_SCREEN_POWER_PANEL_BLANK_UA,
+    CONFIG_DONGLE_SCREEN_POWER_PANEL_SLEEP_UA,
+};
+
+K_MUTEX_DEFINE(display_power_mutex);
+
+static struct k_spinlock stats_lock;
+static enum display_power_state state = DISPLAY_POWER_ACTIVE;
+static uint8_t backlight_level = 0;
+static uint32_t transitions = 0;
+static uint64_t residency_ms[DISPLAY_POWER_STATE_COUNT];
+static uint64_t charge_ua_ms[DISPLAY_POWER_STATE_COUNT]; // Integrated current, divided by residency for the average
+static int64_t last_account = 0;
+
+/* ============================
+ *      Statistics
+ * ============================ */
+
+static uint32_t current_estimate_ua(enum display_power_state s, uint8_t level)
+{
+    return panel_ua[s] + (uint32_t)CONFIG_DONGLE_SCREEN_POWER_BACKLIGHT_UA * level / 100;
+}
+
+// Books the time since the last call to the current state, caller holds stats_lock
+static void account_locked(void)
+{
+    int64_t now = k_uptime_get();
+    int64_t delta = now - last_account;
+
+    residency_ms[state] += delta;
+    charge_ua_ms[state] += (uint64_t)current_estimate_ua(state, backlight_level) * delta;
+    last_account = now;
+}
+
+void display_power_note_backlight(uint8_t level)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    account_locked();
+    backlight_level = level;
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+void display_power_get_stats(struct display_power_stats *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    account_locked();
+    stats->state = state;
+    stats->transitions = transitions;
+
+    uint64_t total_charge = 0;
+    uint64_t total_ms = 0;
+    for (int i = 0; i < DISPLAY_POWER_STATE_COUNT; i++) {
+        stats->residency_ms[i] = (uint32_t)residency_ms[i];
+        // Time weighted over the residency, nominal value for states not visited yet
+        stats->estimated_ua[i] = residency_ms[i] > 0
+                                     ? (uint32_t)(charge_ua_ms[i] / residency_ms[i])
+                                     : current_estimate_ua(i, i < DISPLAY_POWER_OFF ? backlight_level : 0);
+        total_charge += charge_ua_ms[i];
+        total_ms += residency_ms[i];
+    }
+    stats->average_ua = total_ms > 0 ? (uint32_t)(total_charge / total_ms) : 0;
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+enum display_power_state display_power_get_state(void)
+{
+    return state;
+}
+
+static int display_power_hid_query(uint8_t *out, uint8_t max_len)
+{
+    struct display_power_stats stats;
+
+    if (max_len < 5) {
+        return -ENOSPC;
+    }
+    display_power_get_stats(&stats);
+    out[0] = stats.state;
+    sys_put_le32(stats.average_ua, &out[1]);
+    return 5;
+}
+
+HID_STATE_DEFINE(display_power, HID_STATE_DISPLAY_POWER, display_power_hid_query);
+
+/* ============================
+ *      LVGL pause / resume
+ * ============================ */
+
+/*
+ * ZMK's display tick (app/src/display/main.c): a k_timer that submits lv_task_handler() to the
+ * display work queue every TICK_MS. ZMK only stops it with CONFIG_ZMK_DISPLAY_BLANK_ON_IDLE,
+ * which this shield leaves off, so without stopping it here the CPU would still wake up 100
+ * times a second while the screen is dark.
+ */
+extern struct k_timer display_timer;
+#define ZMK_DISPLAY_TICK_MS 10
+
+static void lvgl_pause_work_handler(struct k_work *work)
+{
+    k_timer_stop(&display_timer);
+    lv_timer_enable(false);
+}
+
+// Redraws the whole screen into panel RAM while the panel is still blanked
+static void lvgl_resume_work_handler(struct k_work *work)
+{
+    lv_timer_enable(true);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    k_timer_start(&display_timer, K_MSEC(ZMK_DISPLAY_TICK_MS), K_MSEC(ZMK_DISPLAY_TICK_MS));
+}
+
+static K_WORK_DEFINE(lvgl_pause_work, lvgl_pause_work_handler);
+static K_WORK_DEFINE(lvgl_resume_work, lvgl_resume_work_handler);
+
+// LVGL must only be touched from the display work queue, wait there for the step to finish
+static void run_on_display_queue(struct k_work *work)
+{
+    struct k_work_sync sync;
+
+    k_work_submit_to_queue(zmk_display_work_q(), work);
+    k_work_flush(work, &sync);
+}
+
+/* ============================
+ *      Device power steps
+ * ============================ */
+
+static void device_power(const struct device *dev, bool on)
+{
+#if IS_ENABLED(CONFIG_PM_DEVICE)
+    int rc = pm_device_action_run(dev, on ? PM_DEVICE_ACTION_RESUME : PM_DEVICE_ACTION_SUSPEND);
+    if (rc < 0 && rc != -EALREADY) {
+        LOG_WRN("%s %s failed (%d)", dev->name, on ? "resume" : "suspend", rc);
+    }
+#endif
+}
+
+// ACTIVE/DIMMED -> OFF: stop the display tick and LVGL timers first, then blank the panel
+static void enter_off(void)
+{
+    run_on_display_queue(&lvgl_pause_work);
+    display_blanking_on(display_dev);
+}
+
+// OFF -> DEEP_OFF: panel SLPIN, then the SPI and PWM pins go to their sleep state
+static void enter_deep_off(void)
+{
+    device_power(display_dev, false);
+    device_power(display_bus, false);
+    device_power(backlight_pwm, false);
+}
+
+// DEEP_OFF -> OFF: reverse order, the bus has to be up before the panel gets SLPOUT
+static void leave_deep_off(void)
+{
+    device_power(backlight_pwm, true);
+    device_power(display_bus, true);
+    device_power(display_dev, true);
+}
+
+// OFF -> ACTIVE/DIMMED: draw a fresh frame, then unblank. The backlight fades in afterwards.
+static void leave_off(void)
+{
+    run_on_display_queue(&lvgl_resume_work);
+    display_blanking_off(display_dev);
+}
+
+static void deep_off_work_handler(struct k_work *work)
+{
+    display_power_set_state(DISPLAY_POWER_DEEP_OFF);
+}
+
+static K_WORK_DELAYABLE_DEFINE(deep_off_work, deep_off_work_handler);
+
+int display_power_set_state(enum display_power_state next)
+{
+    if (next >= DISPLAY_POWER_STATE_COUNT) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&display_power_mutex, K_FOREVER);
+
+    enum display_power_state prev = state;
+    if (prev == next) {
+        k_mutex_unlock(&display_power_mutex);
+        return 0;
+    }
+
+    // Only a screen that stayed off escalates to deep-off
+    if (next == DISPLAY_POWER_DEEP_OFF && prev != DISPLAY_POWER_OFF) {
+        k_mutex_unlock(&display_power_mutex);
+        return -EPERM;
+    }
+
+    bool was_dark = prev >= DISPLAY_POWER_OFF;
+    bool dark = next >= DISPLAY_POWER_OFF;
+
+    if (!was_dark && dark) {
+        enter_off();
+    }
+    if (next == DISPLAY_POWER_DEEP_OFF) {
+        enter_deep_off();
+    }
+    if (prev == DISPLAY_POWER_DEEP_OFF) {
+        leave_deep_off();
+    }
+    if (was_dark && !dark) {
+        leave_off();
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    account_locked();
+    state = next;
+    transitions++;
+    k_spin_unlock(&stats_lock, key);
+
+    if (next == DISPLAY_POWER_OFF) {
+        k_work_reschedule(&deep_off_work, K_SECONDS(CONFIG_DONGLE_SCREEN_POWER_DEEP_OFF_DELAY_S));
+    } else if (next != DISPLAY_POWER_DEEP_OFF) {
+        k_work_cancel_delayable(&deep_off_work);
+    }
+
+    LOG_INF("Display power %s -> %s (~%u uA)", state_names[prev], state_names[next],
+            current_estimate_ua(next, next >= DISPLAY_POWER_OFF ? 0 : backlight_level));
+
+    k_mutex_unlock(&display_power_mutex);
+    return 0;
+}
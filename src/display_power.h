@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Power states of the whole display path (backlight, panel, SPI bus, LVGL)
+ */
+enum display_power_state {
+    DISPLAY_POWER_ACTIVE,   // Backlight at user level, panel on, LVGL rendering
+    DISPLAY_POWER_DIMMED,   // Same as active with the idle dim backlight level
+    DISPLAY_POWER_OFF,      // Backlight off, panel DISPOFF, LVGL paused
+    DISPLAY_POWER_DEEP_OFF, // Additionally panel SLPIN, SPI and PWM pins in sleep state
+    DISPLAY_POWER_STATE_COUNT,
+};
+
+/**
+ * @brief Residency and current estimates per power state
+ */
+struct display_power_stats {
+    enum display_power_state state;
+    uint32_t transitions;
+    uint32_t residency_ms[DISPLAY_POWER_STATE_COUNT]; // Time spent in each state since boot
+    uint32_t estimated_ua[DISPLAY_POWER_STATE_COUNT]; // Estimated current draw of each state
+    uint32_t average_ua;                              // Time weighted average since boot
+};
+
+/**
+ * @brief Move the display path into a power state
+ * Blocks until all steps are done. Must be called from a thread, never from the display work queue.
+ * The backlight fade is handled by the caller (fade thread): fade out before entering
+ * an off state, fade in after leaving it.
+ */
+int display_power_set_state(enum display_power_state state);
+
+/**
+ * @brief Current power state
+ */
+enum display_power_state display_power_get_state(void);
+
+/**
+ * @brief Report a backlight level change (0-100) for the current estimate
+ */
+void display_power_note_backlight(uint8_t level);
+
+/**
+ * @brief Copy the current power statistics
+ */
+void display_power_get_stats(struct display_power_stats *stats);
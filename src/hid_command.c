@@ -0,0 +1,160 @@
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+
+#include "hid_command.h"
+#include "hid_response.h"
+
+LOG_MODULE_REGISTER(hid_command, LOG_LEVEL_DBG);
+
+/*
+ * 命令 ID -> 段内下标 + 1，0 表示未注册
+ * 启动时根据链接段建一次表，之后每次分发都是一次数组访问
+ */
+static uint8_t command_index[256];
+
+static int hid_command_index_init(void)
+{
+    int count;
+    STRUCT_SECTION_COUNT(hid_command, &count);
+    __ASSERT(count < 256, "too many HID commands");
+
+    int i = 0;
+    STRUCT_SECTION_FOREACH(hid_command, cmd) {
+        if (command_index[cmd->id] != 0) {
+            LOG_ERR("HID 命令 %u 重复注册，忽略后者", cmd->id);
+        } else {
+            command_index[cmd->id] = i + 1;
+        }
+        i++;
+    }
+
+    LOG_DBG("已注册 %d 个 HID 命令", count);
+    return 0;
+}
+
+SYS_INIT(hid_command_index_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+const struct hid_command *hid_command_find(uint8_t id)
+{
+    uint8_t slot = command_index[id];
+    if (slot == 0) {
+        return NULL;
+    }
+
+    const struct hid_command *cmd;
+    STRUCT_SECTION_GET(hid_command, slot - 1, &cmd);
+    return cmd;
+}
+
+int hid_command_dispatch(const uint8_t *data, uint8_t len)
+{
+    if (len == 0) {
+        return -EMSGSIZE;
+    }
+
+    const struct hid_command *cmd = hid_command_find(data[0]);
+    if (!cmd || !cmd->handler) {
+        LOG_DBG("未知 HID 命令 %u", data[0]);
+        return -ENOTSUP;
+    }
+
+    if (len - 1 < cmd->min_len) {
+        LOG_WRN("HID 命令 %u 长度不足: %u < %u", cmd->id, len - 1, cmd->min_len);
+        return -EMSGSIZE;
+    }
+
+    return cmd->handler(data + 1, len - 1);
+}
+
+/* ============================
+ *      TLV 帧
+ * ============================ */
+
+/*
+ * 帧格式（payload 为 HID_CMD_FRAME 之后的数据）：
+ *   [version][seq][count] { [type][len][value * len] } * count
+ * type 为普通命令 ID，value 即该命令的 payload，直接指向报告缓冲区。
+ * 先校验全部记录，任何一条无效则整帧不执行，保证同一帧内的更新要么全部生效要么都不生效。
+ * 每一帧都回复一条 ACK，带上 seq 和每条记录的状态。
+ */
+
+/* 第一遍：只校验 */
+static int hid_frame_validate(const uint8_t *records, uint8_t records_len, uint8_t seq, uint8_t count)
+{
+    uint16_t off = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (off + 2 > records_len) {
+            LOG_WRN("HID 帧 %u: 记录 %u 头部越界", seq, i);
+            return -EMSGSIZE;
+        }
+
+        uint8_t type = records[off];
+        uint8_t rec_len = records[off + 1];
+        if (off + 2 + rec_len > records_len) {
+            LOG_WRN("HID 帧 %u: 记录 %u 数据越界", seq, i);
+            return -EMSGSIZE;
+        }
+
+        /* 不允许嵌套帧 */
+        const struct hid_command *cmd = type == HID_CMD_FRAME ? NULL : hid_command_find(type);
+        if (!cmd || !cmd->handler) {
+            LOG_WRN("HID 帧 %u: 记录 %u 命令 %u 无效", seq, i, type);
+            return -ENOTSUP;
+        }
+        if (rec_len < cmd->min_len) {
+            LOG_WRN("HID 帧 %u: 命令 %u 长度不足: %u < %u", seq, type, rec_len, cmd->min_len);
+            return -EMSGSIZE;
+        }
+
+        off += 2 + rec_len;
+    }
+
+    return 0;
+}
+
+static int hid_frame_handler(const uint8_t *payload, uint8_t len)
+{
+    uint8_t version = payload[0];
+    uint8_t seq = payload[1];
+    uint8_t count = payload[2];
+
+    if (version != HID_FRAME_VERSION) {
+        LOG_WRN("HID 帧版本 %u 不支持", version);
+        hid_response_ack(seq, HID_STATUS_BAD_VERSION, NULL, 0);
+        return -ENOTSUP;
+    }
+
+    const uint8_t *records = payload + HID_FRAME_HEADER_LEN;
+    uint8_t records_len = len - HID_FRAME_HEADER_LEN;
+
+    int err = hid_frame_validate(records, records_len, seq, count);
+    if (err < 0) {
+        hid_response_ack(seq, hid_response_status(err), NULL, 0);
+        return err;
+    }
+
+    /* 第二遍：依次执行，全部在同一个工作项中完成，中间不会刷新屏幕 */
+    uint8_t statuses[HID_ACK_MAX_RECORDS];
+    int ret = 0;
+    uint16_t off = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const struct hid_command *cmd = hid_command_find(records[off]);
+        uint8_t rec_len = records[off + 1];
+
+        err = cmd->handler(&records[off + 2], rec_len);
+        if (err < 0 && ret == 0) {
+            ret = err;
+        }
+        if (i < HID_ACK_MAX_RECORDS) {
+            statuses[i] = hid_response_status(err);
+        }
+        off += 2 + rec_len;
+    }
+
+    LOG_DBG("HID 帧 %u: 执行 %u 条命令", seq, count);
+    hid_response_ack(seq, hid_response_status(ret), statuses, MIN(count, HID_ACK_MAX_RECORDS));
+    return ret;
+}
+
+HID_COMMAND_DEFINE(frame, HID_CMD_FRAME, HID_FRAME_HEADER_LEN, hid_frame_handler);
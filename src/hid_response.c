@@ -0,0 +1,161 @@
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include <raw_hid/events.h>
+
+#include "hid_command.h"
+#include "hid_response.h"
+
+/* 回复缓冲区，事件发出时同步发送，发送完即可复用 */
+static uint8_t response_buf[CONFIG_RAW_HID_REPORT_SIZE];
+
+uint8_t hid_response_status(int err)
+{
+    switch (err) {
+    case 0:
+        return HID_STATUS_OK;
+    case -ENOTSUP:
+        return HID_STATUS_UNKNOWN_COMMAND;
+    case -EMSGSIZE:
+        return HID_STATUS_BAD_LENGTH;
+    case -ENODEV:
+        return HID_STATUS_NOT_READY;
+    case -EINVAL:
+        return HID_STATUS_BAD_ARGUMENT;
+    case -ESPIPE:
+        return HID_STATUS_BAD_OFFSET;
+    case -EBADMSG:
+        return HID_STATUS_BAD_CRC;
+    default:
+        return err < 0 ? HID_STATUS_FAILED : HID_STATUS_OK;
+    }
+}
+
+int hid_response_send(const uint8_t *data, uint8_t len)
+{
+    if (len > sizeof(response_buf)) {
+        return -EMSGSIZE;
+    }
+
+    if (data != response_buf) {
+        memcpy(response_buf, data, len);
+    }
+    memset(response_buf + len, 0, sizeof(response_buf) - len);
+
+    raise_raw_hid_sent_event(
+        (struct raw_hid_sent_event){.data = response_buf, .length = sizeof(response_buf)});
+    return 0;
+}
+
+int hid_response_ack(uint8_t seq, uint8_t status, const uint8_t *statuses, uint8_t count)
+{
+    count = MIN(count, HID_ACK_MAX_RECORDS);
+
+    response_buf[0] = HID_RSP_ACK;
+    response_buf[1] = seq;
+    response_buf[2] = status;
+    response_buf[3] = count;
+    if (statuses && count) {
+        memcpy(&response_buf[4], statuses, count);
+    }
+
+    return hid_response_send(response_buf, 4 + count);
+}
+
+/* ============================
+ *      能力查询
+ * ============================ */
+
+/* 请求：[seq] */
+static int hid_capabilities_handler(const uint8_t *payload, uint8_t len)
+{
+    uint8_t n = 0;
+    uint8_t off = 7;
+
+    response_buf[0] = HID_CMD_CAPABILITIES;
+    response_buf[1] = payload[0];
+    response_buf[2] = HID_PROTOCOL_VERSION;
+    response_buf[3] = HID_FRAME_VERSION;
+    response_buf[4] = CONFIG_RAW_HID_REPORT_SIZE;
+    response_buf[5] = CONFIG_DONGLE_SCREEN_RAW_HID_QUEUE_SIZE;
+
+    /* 列出所有命令和状态记录 ID，放不下的部分截断 */
+    STRUCT_SECTION_FOREACH(hid_command, cmd) {
+        if (off >= sizeof(response_buf)) {
+            break;
+        }
+        response_buf[off++] = cmd->id;
+        n++;
+    }
+    response_buf[6] = n;
+
+    return hid_response_send(response_buf, off);
+}
+
+HID_COMMAND_DEFINE(capabilities, HID_CMD_CAPABILITIES, 1, hid_capabilities_handler);
+
+/* ============================
+ *      状态快照
+ * ============================ */
+
+/* type 列表以 0 或报告结尾为止，报告中多余的部分是补 0 */
+static bool state_requested(const uint8_t *types, uint8_t n, uint8_t id)
+{
+    if (n == 0 || types[0] == 0) {
+        return true;
+    }
+    for (uint8_t i = 0; i < n && types[i] != 0; i++) {
+        if (types[i] == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * 请求：[seq][type * n]，不带 type 表示全部
+ * 记录与命令 payload 格式相同，主机可以原样保存，之后只发送变化的部分。
+ * 一条报告放不下时 more 置 1，主机可以按 type 分批查询。
+ */
+static int hid_state_handler(const uint8_t *payload, uint8_t len)
+{
+    const uint8_t *types = payload + 1;
+    uint8_t n = len - 1;
+    uint8_t count = 0;
+    uint8_t more = 0;
+    uint8_t off = 4;
+
+    response_buf[0] = HID_CMD_STATE;
+    response_buf[1] = payload[0];
+
+    STRUCT_SECTION_FOREACH(hid_command, cmd) {
+        if (!cmd->query || !state_requested(types, n, cmd->id)) {
+            continue;
+        }
+        if (off + 2 >= sizeof(response_buf)) {
+            more = 1;
+            break;
+        }
+
+        int rec_len = cmd->query(&response_buf[off + 2], sizeof(response_buf) - off - 2);
+        if (rec_len == -ENOSPC) {
+            more = 1;
+            continue;
+        }
+        if (rec_len < 0) {
+            continue;  // 没有可报告的值，例如时钟尚未同步
+        }
+
+        response_buf[off] = cmd->id;
+        response_buf[off + 1] = rec_len;
+        off += 2 + rec_len;
+        count++;
+    }
+
+    response_buf[2] = count;
+    response_buf[3] = more;
+
+    return hid_response_send(response_buf, off);
+}
+
+HID_COMMAND_DEFINE(state, HID_CMD_STATE, 1, hid_state_handler);
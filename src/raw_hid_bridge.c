@@ -1,26 +1,88 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
 #include <string.h>
 #include <stdint.h>
 
 #include "raw_hid_bridge.h"
+#include "activity.h"
 #include <raw_hid/events.h>
 
 LOG_MODULE_REGISTER(raw_hid_bridge, LOG_LEVEL_DBG);
 
-/* 静态 HID 缓冲区 */
-static uint8_t hid_buf[CONFIG_RAW_HID_REPORT_SIZE];
-static atomic_t hid_buf_ready = ATOMIC_INIT(false);
+#define QUEUE_SIZE CONFIG_DONGLE_SCREEN_RAW_HID_QUEUE_SIZE
 
-/* 对外接口：获取一次 HID 数据 */
-const uint8_t *raw_hid_bridge_get_buffer(void)
+BUILD_ASSERT(IS_POWER_OF_TWO(QUEUE_SIZE), "DONGLE_SCREEN_RAW_HID_QUEUE_SIZE must be a power of two");
+
+/*
+ * 单生产者 / 单消费者环形队列
+ * 生产者：raw_hid_received_event 监听器，只写 head
+ * 消费者：HID 工作函数，只写 tail
+ * head/tail 自由递增，取模得到槽位；head - tail 即为当前深度
+ */
+static struct raw_hid_report queue[QUEUE_SIZE];
+static atomic_t head = ATOMIC_INIT(0);
+static atomic_t tail = ATOMIC_INIT(0);
+
+/* 统计，只由生产者写 */
+static uint32_t received = 0;
+static atomic_t dropped = ATOMIC_INIT(0);
+static uint32_t high_water = 0;
+
+/* 延迟统计，只由消费者写 */
+static uint32_t latency_last_us = 0;
+static uint32_t latency_max_us = 0;
+static uint64_t latency_sum_us = 0;
+static uint32_t latency_count = 0;
+
+static raw_hid_bridge_notify_t notify_cb = NULL;
+
+/* 主机流量只维持屏幕亮度，不唤醒 */
+ACTIVITY_SOURCE_DEFINE(raw_hid, ACTIVITY_HOLD, CONFIG_DONGLE_SCREEN_ACTIVITY_RAW_HID_HOLD_MS);
+
+/* 对外接口：查看最早的报告 */
+const struct raw_hid_report *raw_hid_bridge_peek(void)
 {
-    atomic_val_t prev = atomic_cas(&hid_buf_ready, true, false);
-    if (prev != (atomic_val_t)true) {
+    atomic_val_t t = atomic_get(&tail);
+    if (t == atomic_get(&head)) {
         return NULL;
     }
-    return hid_buf;
+    return &queue[t & (QUEUE_SIZE - 1)];
+}
+
+/* 对外接口：释放最早的报告，槽位交还给生产者 */
+void raw_hid_bridge_pop(void)
+{
+    atomic_val_t t = atomic_get(&tail);
+    if (t == atomic_get(&head)) {
+        return;
+    }
+
+    /* 槽位交还前记录处理延迟 */
+    uint32_t cycles = k_cycle_get_32() - queue[t & (QUEUE_SIZE - 1)].rx_cycles;
+    latency_last_us = k_cyc_to_us_floor32(cycles);
+    latency_max_us = MAX(latency_max_us, latency_last_us);
+    latency_sum_us += latency_last_us;
+    latency_count++;
+
+    atomic_set(&tail, t + 1);
+}
+
+void raw_hid_bridge_set_notify(raw_hid_bridge_notify_t notify)
+{
+    notify_cb = notify;
+}
+
+void raw_hid_bridge_get_stats(struct raw_hid_bridge_stats *stats)
+{
+    stats->received = received;
+    stats->dropped = atomic_get(&dropped);
+    stats->high_water = high_water;
+    stats->capacity = QUEUE_SIZE;
+    stats->latency_last_us = latency_last_us;
+    stats->latency_max_us = latency_max_us;
+    stats->latency_avg_us = latency_count ? (uint32_t)(latency_sum_us / latency_count) : 0;
 }
 
 /* HID 接收事件回调 */
@@ -30,13 +92,41 @@ static int raw_hid_received_event_listener(const zmk_event_t *eh) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
-    /* 固定长度复制 */
-    memcpy(hid_buf, event->data, CONFIG_RAW_HID_REPORT_SIZE);
+    atomic_val_t h = atomic_get(&head);
+    uint32_t depth = h - atomic_get(&tail);
+
+    /* 队列满：丢弃新报告，已排队的报告保持完整 */
+    if (depth >= QUEUE_SIZE) {
+        atomic_inc(&dropped);
+        LOG_WRN("HID 队列已满，丢弃报告 buf[0]=%u", (unsigned)event->data[0]);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    /* 槽位在 head 发布前只属于生产者，不会被读到一半 */
+    struct raw_hid_report *slot = &queue[h & (QUEUE_SIZE - 1)];
+    slot->rx_cycles = k_cycle_get_32();
+    uint8_t len = MIN(event->length, CONFIG_RAW_HID_REPORT_SIZE);
+    memcpy(slot->data, event->data, len);
+    memset(slot->data + len, 0, CONFIG_RAW_HID_REPORT_SIZE - len);
+    slot->length = len;
+
+    /* 发布报告 */
+    atomic_set(&head, h + 1);
+
+    received++;
+    if (depth + 1 > high_water) {
+        high_water = depth + 1;
+    }
+
+    /* 通知消费者，已排队的处理工作会一并处理新报告 */
+    raw_hid_bridge_notify_t notify = notify_cb;
+    if (notify) {
+        notify();
+    }
 
-    /* 标记为新数据 */
-    atomic_set(&hid_buf_ready, true);
+    activity_signal(ACTIVITY_SOURCE(raw_hid));
 
-    LOG_DBG("HID 报告已接收, buf[0]=%u", (unsigned)hid_buf[0]);
+    LOG_DBG("HID 报告已接收, buf[0]=%u, 队列深度 %u", (unsigned)slot->data[0], depth + 1);
     return ZMK_EV_EVENT_BUBBLE;
 }
 
@@ -1,7 +1,11 @@
 #include "battery.h"
 
 #include <lvgl.h>
+#include <stdio.h>
+#include <string.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
 #include <zmk/display.h>
 #include <zmk/ble.h>
 #include <zmk/events/battery_state_changed.h>
@@ -9,25 +13,162 @@
 #include <zmk/event_manager.h>
 
 #include "fonts/lv_font_jetbrainsmono_20.h"
+#include "hid_command.h"
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_HISTORY)
+#include "battery_history.h"
+#endif
 
 LOG_MODULE_REGISTER(widget_battery, LOG_LEVEL_DBG);
 
 static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
 
-// 电池状态结构体
-struct battery_state {
-    uint8_t source;
-    uint8_t level;
+/* ============================
+ *      共享样式
+ * ============================ */
+
+/*
+ * 各电量档位的颜色放在只读的常量样式中，所有电池条共用。
+ * 样式表在 flash 中，不占 LVGL 内存池；切换档位时只替换样式指针，
+ * 电量更新不再给每个对象添加或修改本地样式属性
+ */
+enum battery_style {
+    BATTERY_STYLE_DISCONNECTED,
+    BATTERY_STYLE_CRITICAL,  // 20% 以下
+    BATTERY_STYLE_LOW,       // 20%-50%
+    BATTERY_STYLE_NORMAL,    // 50% 以上
+    BATTERY_STYLE_COUNT,
+};
+
+#define BATTERY_TEXT_WARN LV_COLOR_MAKE(0xFF, 0xB8, 0x02)
+#define BATTERY_TEXT_NORMAL LV_COLOR_MAKE(0xFF, 0xFF, 0xFF)
+
+// 每个档位三个样式：电池条底色、电池条指示部分、标签
+#define BATTERY_STYLE_DEFINE(name, main_color, indicator_color, text_color)                        \
+    static const lv_style_const_prop_t name##_main_props[] = {                                     \
+        LV_STYLE_CONST_BG_COLOR(main_color),                                                       \
+        LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),                                                       \
+        LV_STYLE_CONST_RADIUS(1),                                                                  \
+        LV_STYLE_CONST_ANIM_TIME(250),                                                             \
+        LV_STYLE_PROP_INV,                                                                         \
+    };                                                                                             \
+    static const lv_style_const_prop_t name##_indicator_props[] = {                                \
+        LV_STYLE_CONST_BG_COLOR(indicator_color),                                                  \
+        LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),                                                       \
+        LV_STYLE_PROP_INV,                                                                         \
+    };                                                                                             \
+    static const lv_style_const_prop_t name##_label_props[] = {                                    \
+        LV_STYLE_CONST_TEXT_FONT(&lv_font_jetbrainsmono_20),                                       \
+        LV_STYLE_CONST_TEXT_COLOR(text_color),                                                     \
+        LV_STYLE_PROP_INV,                                                                         \
+    };                                                                                             \
+    static LV_STYLE_CONST_INIT(name##_main, name##_main_props);                                    \
+    static LV_STYLE_CONST_INIT(name##_indicator, name##_indicator_props);                          \
+    static LV_STYLE_CONST_INIT(name##_label, name##_label_props)
+
+/* 未连接和 20% 以下：红色系（偏暗红） */
+BATTERY_STYLE_DEFINE(style_disconnected, LV_COLOR_MAKE(80, 20, 20), LV_COLOR_MAKE(180, 40, 40),
+                     BATTERY_TEXT_WARN);
+BATTERY_STYLE_DEFINE(style_critical, LV_COLOR_MAKE(80, 20, 20), LV_COLOR_MAKE(180, 40, 40),
+                     BATTERY_TEXT_WARN);
+/* 20%-50%：橙色系 */
+BATTERY_STYLE_DEFINE(style_low, LV_COLOR_MAKE(110, 78, 7), LV_COLOR_MAKE(211, 144, 15),
+                     BATTERY_TEXT_NORMAL);
+/* 50%以上：偏白一点的灰色系 */
+BATTERY_STYLE_DEFINE(style_normal, LV_COLOR_MAKE(60, 60, 60), LV_COLOR_MAKE(200, 200, 200),
+                     BATTERY_TEXT_NORMAL);
+
+struct battery_styles {
+    const lv_style_t *main;
+    const lv_style_t *indicator;
+    const lv_style_t *label;
 };
 
+#define BATTERY_STYLES(name) {&name##_main, &name##_indicator, &name##_label}
+
+static const struct battery_styles battery_styles[BATTERY_STYLE_COUNT] = {
+    [BATTERY_STYLE_DISCONNECTED] = BATTERY_STYLES(style_disconnected),
+    [BATTERY_STYLE_CRITICAL] = BATTERY_STYLES(style_critical),
+    [BATTERY_STYLE_LOW] = BATTERY_STYLES(style_low),
+    [BATTERY_STYLE_NORMAL] = BATTERY_STYLES(style_normal),
+};
+
+// 单个电池的容器：透明、无边框、无内边距
+static const lv_style_const_prop_t container_props[] = {
+    LV_STYLE_CONST_BG_OPA(LV_OPA_TRANSP),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_TRANSP),
+    LV_STYLE_CONST_PAD_TOP(0),
+    LV_STYLE_CONST_PAD_BOTTOM(0),
+    LV_STYLE_CONST_PAD_LEFT(0),
+    LV_STYLE_CONST_PAD_RIGHT(0),
+    LV_STYLE_PROP_INV,
+};
+static LV_STYLE_CONST_INIT(style_container, container_props);
+
+static enum battery_style level_to_style(uint8_t level) {
+    if (level == 0) {
+        return BATTERY_STYLE_DISCONNECTED;
+    } else if (level < 20) {
+        return BATTERY_STYLE_CRITICAL;
+    } else if (level < 50) {
+        return BATTERY_STYLE_LOW;
+    }
+    return BATTERY_STYLE_NORMAL;
+}
+
 // 电池UI对象
 typedef struct {
     lv_obj_t *bar;
     lv_obj_t *label;
+    uint8_t style;  // 当前使用的 enum battery_style
+    char text[10];  // 标签文本（电量和剩余时间），标签直接引用，不另外分配
 } battery_ui_t;
 
 static battery_ui_t battery_uis[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
 
+// 最近一次收到的电量，供 HID 状态查询，0 表示未连接
+static uint8_t battery_levels[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_HISTORY)
+/*
+ * 电量历史：每个外设一份，dongle 自己有电池时最后再加一份。
+ * 只在显示工作队列中访问（电量更新工作项和 HID 查询）
+ */
+#define BATTERY_SOURCE_DONGLE ZMK_SPLIT_BLE_PERIPHERAL_COUNT
+#define BATTERY_SOURCE_COUNT                                                                       \
+    (ZMK_SPLIT_BLE_PERIPHERAL_COUNT + IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING))
+
+static struct battery_history battery_histories[BATTERY_SOURCE_COUNT];
+static uint8_t battery_source_levels[BATTERY_SOURCE_COUNT];
+
+// 剩余时间的短格式：45m、12h、3d
+static void format_eta(char *buf, size_t size, uint16_t minutes) {
+    if (minutes < 60) {
+        snprintf(buf, size, "%um", minutes);
+    } else if (minutes < 100 * 60) {
+        snprintf(buf, size, "%uh", minutes / 60);
+    } else {
+        snprintf(buf, size, "%ud", minutes / (24 * 60));
+    }
+}
+#endif
+
+// 替换共享样式的指针，不分配内存；档位不变时什么都不做
+static void set_battery_style(battery_ui_t *ui, enum battery_style style) {
+    if (ui->style == style) {
+        return;
+    }
+
+    const struct battery_styles *from = &battery_styles[ui->style];
+    const struct battery_styles *to = &battery_styles[style];
+
+    lv_obj_replace_style(ui->bar, (lv_style_t *)from->main, (lv_style_t *)to->main, LV_PART_MAIN);
+    lv_obj_replace_style(ui->bar, (lv_style_t *)from->indicator, (lv_style_t *)to->indicator,
+                         LV_PART_INDICATOR);
+    lv_obj_replace_style(ui->label, (lv_style_t *)from->label, (lv_style_t *)to->label, 0);
+    ui->style = style;
+}
+
 // 设置单个电池显示
 static void set_battery_display(uint8_t source, uint8_t level) {
     if (source >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT) return;
@@ -39,104 +180,182 @@ static void set_battery_display(uint8_t source, uint8_t level) {
         return;
     }
     
+    set_battery_style(ui, level_to_style(level));
+
     if (level == 0) {
-        // 未连接状态：显示红色电池条
-        lv_bar_set_value(ui->bar, 100, LV_ANIM_ON); // 显示满条
-        lv_obj_set_style_bg_color(ui->bar, lv_color_make(180, 40, 40), LV_PART_INDICATOR);
-        lv_obj_set_style_bg_color(ui->bar, lv_color_make(80, 20, 20), LV_PART_MAIN);
-        lv_label_set_text(ui->label, "--");
-        lv_obj_set_style_text_color(ui->label, lv_color_hex(0xFFB802), 0);
+        // 未连接状态：显示红色满条
+        lv_bar_set_value(ui->bar, 100, LV_ANIM_ON);
+        lv_label_set_text_static(ui->label, "--");
     } else {
-        // 正常连接状态
         lv_bar_set_value(ui->bar, level, LV_ANIM_ON);
-        
-        // 设置颜色
-        if (level < 20) {
-            /* 20%以下：红色系（偏暗红） */
-            lv_obj_set_style_bg_color(ui->bar, lv_color_make(180, 40, 40), LV_PART_INDICATOR);
-            lv_obj_set_style_bg_color(ui->bar, lv_color_make(80, 20, 20), LV_PART_MAIN);
-            lv_obj_set_style_text_color(ui->label, lv_color_hex(0xFFB802), 0);
-        } else if (level < 50) {
-            /* 20%-50%：保持原来的橙色系 */
-            lv_obj_set_style_bg_color(ui->bar, lv_color_make(211, 144, 15), LV_PART_INDICATOR);
-            lv_obj_set_style_bg_color(ui->bar, lv_color_make(110, 78, 7), LV_PART_MAIN);
-            lv_obj_set_style_text_color(ui->label, lv_color_hex(0xFFFFFF), 0);
-        } else {
-            /* 50%以上：偏白一点的灰色系 */
-            lv_obj_set_style_bg_color(ui->bar, lv_color_make(200, 200, 200), LV_PART_INDICATOR);
-            lv_obj_set_style_bg_color(ui->bar, lv_color_make(60, 60, 60), LV_PART_MAIN);
-            lv_obj_set_style_text_color(ui->label, lv_color_hex(0xFFFFFF), 0);
+        int len = snprintf(ui->text, sizeof(ui->text), "%d", level);
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_ETA_LABEL)
+        // 电量后面显示预计剩余时间，还不能估计时只显示电量
+        struct battery_estimate estimate;
+        if (battery_history_estimate(&battery_histories[source], &estimate) &&
+            estimate.eta_min != BATTERY_ETA_UNKNOWN) {
+            ui->text[len++] = ' ';
+            format_eta(&ui->text[len], sizeof(ui->text) - len, estimate.eta_min);
         }
-        
-        // 更新标签文本
-        lv_label_set_text_fmt(ui->label, "%d", level);
+#else
+        ARG_UNUSED(len);
+#endif
+        lv_label_set_text_static(ui->label, ui->text);
     }
 }
 
-// 电池事件回调
-static void battery_update_cb(struct battery_state state) {
-    LOG_DBG("电池更新: 源=%d, 电量=%d%%", state.source, state.level);
-    
+// 在显示工作队列中处理一个来源的新电量
+static void battery_update(uint8_t source, uint8_t level) {
+    LOG_DBG("电池更新: 源=%d, 电量=%d%%", source, level);
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_HISTORY)
+    battery_source_levels[source] = level;
+    battery_history_add(&battery_histories[source], k_uptime_get(), level);
+#endif
+
+    // dongle 自己的电池只进入电量历史，没有对应的电池条
+    if (source >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+        return;
+    }
+    battery_levels[source] = level;
+
     struct zmk_widget_battery *widget;
     SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
-        set_battery_display(state.source, state.level);
+        set_battery_display(source, level);
+    }
+}
+
+/*
+ * 事件中只暂存电量，每个来源一个位置，显示工作队列中统一处理。
+ * 不用 ZMK_DISPLAY_WIDGET_LISTENER：它只有一个状态槽，两个外设的事件接连到达时
+ * （比如重连）前一个的电量会被覆盖，既不更新电池条也不进入电量历史
+ */
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_HISTORY)
+#define BATTERY_PENDING_COUNT BATTERY_SOURCE_COUNT
+#else
+#define BATTERY_PENDING_COUNT ZMK_SPLIT_BLE_PERIPHERAL_COUNT
+#endif
+
+BUILD_ASSERT(BATTERY_PENDING_COUNT <= ATOMIC_BITS);
+
+static uint8_t battery_pending_levels[BATTERY_PENDING_COUNT];
+static atomic_t battery_pending;  // 有新电量的来源，位 i 对应来源 i
+
+static void battery_update_work_handler(struct k_work *work) {
+    atomic_val_t pending = atomic_clear(&battery_pending);
+
+    for (int source = 0; source < BATTERY_PENDING_COUNT; source++) {
+        if (pending & BIT(source)) {
+            battery_update(source, battery_pending_levels[source]);
+        }
     }
 }
 
-// 从事件获取电池状态
-static struct battery_state battery_get_state(const zmk_event_t *eh) {
-    const struct zmk_peripheral_battery_state_changed *ev = 
+static K_WORK_DEFINE(battery_update_work, battery_update_work_handler);
+
+static int battery_listener(const zmk_event_t *eh) {
+    uint8_t source;
+    uint8_t level;
+
+    const struct zmk_peripheral_battery_state_changed *ev =
         as_zmk_peripheral_battery_state_changed(eh);
-    
-    if (!ev) {
-        return (struct battery_state){.source = 0, .level = 0};
+    if (ev) {
+        if (ev->source >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+            return ZMK_EV_EVENT_BUBBLE;
+        }
+        source = ev->source;
+        level = ev->state_of_charge;
+    } else {
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_HISTORY) && IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+        const struct zmk_battery_state_changed *own = as_zmk_battery_state_changed(eh);
+        if (!own) {
+            return ZMK_EV_EVENT_BUBBLE;
+        }
+        source = BATTERY_SOURCE_DONGLE;
+        level = own->state_of_charge;
+#else
+        return ZMK_EV_EVENT_BUBBLE;
+#endif
     }
-    
-    return (struct battery_state){
-        .source = ev->source,
-        .level = ev->state_of_charge,
-    };
+
+    // 先写电量再置位，工作项清除位之后读到的一定是最新的电量
+    battery_pending_levels[source] = level;
+    atomic_set_bit(&battery_pending, source);
+    k_work_submit_to_queue(zmk_display_work_q(), &battery_update_work);
+    return ZMK_EV_EVENT_BUBBLE;
 }
 
-// 注册事件监听器
-ZMK_DISPLAY_WIDGET_LISTENER(widget_battery, struct battery_state,
-                            battery_update_cb, battery_get_state)
+ZMK_LISTENER(widget_battery, battery_listener);
 ZMK_SUBSCRIPTION(widget_battery, zmk_peripheral_battery_state_changed);
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_HISTORY) && IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+ZMK_SUBSCRIPTION(widget_battery, zmk_battery_state_changed);
+#endif
+
+// HID 状态查询：每个外设一个字节
+static int battery_hid_query(uint8_t *out, uint8_t max_len) {
+    if (max_len < ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+        return -ENOSPC;
+    }
+    memcpy(out, battery_levels, ZMK_SPLIT_BLE_PERIPHERAL_COUNT);
+    return ZMK_SPLIT_BLE_PERIPHERAL_COUNT;
+}
+
+HID_STATE_DEFINE(battery, HID_STATE_BATTERY, battery_hid_query);
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_HISTORY)
+// HID 状态查询：每个来源 [电量][速率 0.01%/h，int16][剩余分钟，uint16]，dongle 在最后
+#define BATTERY_ETA_RECORD_LEN 5
+
+static int battery_eta_hid_query(uint8_t *out, uint8_t max_len) {
+    if (max_len < BATTERY_SOURCE_COUNT * BATTERY_ETA_RECORD_LEN) {
+        return -ENOSPC;
+    }
+
+    for (int i = 0; i < BATTERY_SOURCE_COUNT; i++) {
+        struct battery_estimate estimate;
+        uint8_t *record = &out[i * BATTERY_ETA_RECORD_LEN];
+
+        battery_history_estimate(&battery_histories[i], &estimate);
+        record[0] = battery_source_levels[i];
+        sys_put_le16(estimate.rate_cph, &record[1]);
+        sys_put_le16(estimate.eta_min, &record[3]);
+    }
+    return BATTERY_SOURCE_COUNT * BATTERY_ETA_RECORD_LEN;
+}
+
+HID_STATE_DEFINE(battery_eta, HID_STATE_BATTERY_ETA, battery_eta_hid_query);
+#endif
 
 // 创建单个电池UI
 static void create_battery_ui(lv_obj_t *parent, int index) {
+    const struct battery_styles *styles = &battery_styles[BATTERY_STYLE_DISCONNECTED];
+
     lv_obj_t *container = lv_obj_create(parent);
+    lv_obj_add_style(container, (lv_style_t *)&style_container, 0);
     lv_obj_set_size(container, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     lv_obj_set_flex_grow(container, 1);
     lv_obj_set_height(container, lv_pct(100));
-    lv_obj_set_style_bg_opa(container, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_opa(container, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_pad_all(container, 0, 0);
 
-    // 电池条
+    // 电池条，初始为未连接状态（红色满条）
     lv_obj_t *bar = lv_bar_create(container);
+    lv_obj_add_style(bar, (lv_style_t *)styles->main, LV_PART_MAIN);
+    lv_obj_add_style(bar, (lv_style_t *)styles->indicator, LV_PART_INDICATOR);
     lv_obj_set_size(bar, lv_pct(100), 5);
     lv_obj_align(bar, LV_ALIGN_BOTTOM_MID, 0, 0);
-    // 初始化颜色为红色（未连接状态）
-    lv_obj_set_style_bg_color(bar, lv_color_make(80, 20, 20), LV_PART_MAIN);
-    lv_obj_set_style_bg_color(bar, lv_color_make(180, 40, 40), LV_PART_INDICATOR);
-    lv_obj_set_style_bg_opa(bar, 255, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(bar, 255, LV_PART_INDICATOR);
-    lv_obj_set_style_radius(bar, 1, LV_PART_MAIN);
-    lv_obj_set_style_anim_time(bar, 250, 0);
-    lv_bar_set_value(bar, 100, LV_ANIM_OFF); // 初始显示满条（红色）
+    lv_bar_set_value(bar, 100, LV_ANIM_OFF);
 
     // 标签
     lv_obj_t *label = lv_label_create(container);
-    lv_obj_set_style_text_font(label, &lv_font_jetbrainsmono_20, 0);
-    lv_obj_set_style_text_color(label, lv_color_hex(0xFFB802), 0); // 初始为橙色
+    lv_obj_add_style(label, (lv_style_t *)styles->label, 0);
     lv_obj_align(label, LV_ALIGN_CENTER, 0, -3);
-    lv_label_set_text(label, "--");
+    lv_label_set_text_static(label, "--");
     
     // 存储UI对象
     battery_uis[index] = (battery_ui_t){
         .bar = bar,
         .label = label,
+        .style = BATTERY_STYLE_DISCONNECTED,
     };
 }
 
@@ -179,7 +398,11 @@ int zmk_widget_battery_bar_init(struct zmk_widget_battery *widget, lv_obj_t *par
     }
     
     sys_slist_append(&widgets, &widget->node);
-    widget_battery_init();
+
+    // 显示创建之前已经收到的电量
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        set_battery_display(i, battery_levels[i]);
+    }
     
     return 0;
 }
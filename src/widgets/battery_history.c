@@ -0,0 +1,153 @@
+#include "battery_history.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <stdlib.h>
+#include <string.h>
+
+LOG_MODULE_DECLARE(widget_battery, LOG_LEVEL_DBG);
+
+#define HISTORY_SIZE CONFIG_DONGLE_SCREEN_BATTERY_HISTORY_SIZE
+
+// 电量比上一个样本高出这么多认为在充电，历史重新开始
+#define CHARGE_STEP 5
+// 比上一个样本一次下降超过这么多个百分点视为离群值
+#define OUTLIER_DROP 8
+// 连续这么多个离群样本后认为电量真的跳变了
+#define OUTLIER_LIMIT 2
+// 连续的离群样本之间相差不超过这么多个百分点才算同一次跳变
+#define OUTLIER_MATCH 2
+// 电量不变时，至少隔这么久才记录一个样本，平稳的电量也能进入拟合
+#define FLAT_INTERVAL_MIN 15
+// 估计所需的最少样本数和最短时间跨度
+#define MIN_SAMPLES 3
+#define MIN_SPAN_MIN 30
+
+void battery_history_reset(struct battery_history *history) {
+    memset(history, 0, sizeof(*history));
+}
+
+static const struct battery_sample *oldest(const struct battery_history *history) {
+    return &history->samples[(history->head + HISTORY_SIZE - history->count) % HISTORY_SIZE];
+}
+
+static const struct battery_sample *newest(const struct battery_history *history) {
+    return &history->samples[(history->head + HISTORY_SIZE - 1) % HISTORY_SIZE];
+}
+
+static void push(struct battery_history *history, uint16_t minute, uint8_t level) {
+    // 窗口已满时淘汰最旧的样本
+    if (history->count == HISTORY_SIZE) {
+        const struct battery_sample *old = oldest(history);
+        history->sum_t -= old->minute;
+        history->sum_l -= old->level;
+        history->sum_tt -= (int64_t)old->minute * old->minute;
+        history->sum_tl -= (int64_t)old->minute * old->level;
+        history->count--;
+    }
+
+    history->samples[history->head] = (struct battery_sample){.minute = minute, .level = level};
+    history->head = (history->head + 1) % HISTORY_SIZE;
+    history->count++;
+
+    history->sum_t += minute;
+    history->sum_l += level;
+    history->sum_tt += (int64_t)minute * minute;
+    history->sum_tl += (int64_t)minute * level;
+}
+
+/*
+ * 最小二乘：斜率 = num / den
+ *   num = nΣtl - ΣtΣl
+ *   den = nΣt² - (Σt)²
+ */
+static bool fit(const struct battery_history *history, int64_t *num, int64_t *den) {
+    int64_t n = history->count;
+
+    if (n < MIN_SAMPLES) {
+        return false;
+    }
+    *num = n * history->sum_tl - (int64_t)history->sum_t * history->sum_l;
+    *den = n * history->sum_tt - (int64_t)history->sum_t * history->sum_t;
+    return *den > 0;
+}
+
+void battery_history_add(struct battery_history *history, int64_t now_ms, uint8_t level) {
+    if (level == 0) {
+        return;
+    }
+
+    if (history->count == 0) {
+        history->base_ms = now_ms;
+        push(history, 0, level);
+        return;
+    }
+
+    int64_t minute = (now_ms - history->base_ms) / 60000;
+    const struct battery_sample *last = newest(history);
+
+    // 超出 16 位分钟数的范围（约 45 天）或充电后重新开始
+    if (minute > UINT16_MAX || level > last->level + CHARGE_STEP) {
+        LOG_DBG("电量历史重新开始: %u%% -> %u%%", last->level, level);
+        battery_history_reset(history);
+        history->base_ms = now_ms;
+        push(history, 0, level);
+        return;
+    }
+
+    /*
+     * 一次下降太多：先丢弃，接近的电量连续出现才接受，接受时即使同一分钟也记录。
+     * 中间夹着正常样本，或者离群电量和上次丢弃的差得远，都重新计数
+     */
+    if (last->level - level > OUTLIER_DROP) {
+        if (history->rejected == 0 ||
+            abs(level - history->rejected_level) > OUTLIER_MATCH) {
+            history->rejected = 0;
+            history->rejected_level = level;
+        }
+        if (++history->rejected < OUTLIER_LIMIT) {
+            LOG_DBG("丢弃离群电量样本 %u%% -> %u%%", last->level, level);
+            return;
+        }
+        history->rejected = 0;
+        push(history, minute, level);
+        return;
+    }
+    history->rejected = 0;
+
+    // 小幅回升（重连或负载降低后电压恢复）不记录，放电曲线保持单调
+    if (level > last->level) {
+        return;
+    }
+
+    if (minute == last->minute ||
+        (level == last->level && minute - last->minute < FLAT_INTERVAL_MIN)) {
+        return;
+    }
+
+    push(history, minute, level);
+}
+
+bool battery_history_estimate(const struct battery_history *history,
+                              struct battery_estimate *estimate) {
+    int64_t num, den;
+
+    estimate->rate_cph = 0;
+    estimate->eta_min = BATTERY_ETA_UNKNOWN;
+
+    if (!fit(history, &num, &den) ||
+        newest(history)->minute - oldest(history)->minute < MIN_SPAN_MIN) {
+        return false;
+    }
+
+    // %/分钟 -> 0.01%/小时
+    int64_t rate = num * 6000 / den;
+    estimate->rate_cph = CLAMP(rate, INT16_MIN, INT16_MAX);
+
+    if (num < 0) {
+        // 剩余分钟 = 当前电量 / 每分钟下降的电量
+        int64_t eta = (int64_t)newest(history)->level * den / -num;
+        estimate->eta_min = MIN(eta, BATTERY_ETA_UNKNOWN - 1);
+    }
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * 电量历史和放电速率估计，由 battery.c 使用
+ *
+ * 每个电量来源一个固定大小的环形缓冲区，样本为（分钟，电量）。
+ * 窗口内的 Σt、Σl、Σt²、Σtl 随样本加入和淘汰增量维护，
+ * 最小二乘斜率的计算与窗口大小无关。全部为整数运算。
+ */
+
+#define BATTERY_ETA_UNKNOWN 0xFFFF
+
+struct battery_sample {
+    uint16_t minute;  // 相对 base_ms 的分钟数
+    uint8_t level;
+};
+
+struct battery_history {
+    struct battery_sample samples[CONFIG_DONGLE_SCREEN_BATTERY_HISTORY_SIZE];
+    uint8_t head;            // 下一个写入位置
+    uint8_t count;
+    uint8_t rejected;        // 连续被当作离群值丢弃的样本数
+    uint8_t rejected_level;  // 第一个被丢弃的离群样本的电量
+    int64_t base_ms;         // 第 0 分钟对应的 uptime
+
+    /* 窗口内样本的累加和 */
+    int32_t sum_t;
+    int32_t sum_l;
+    int64_t sum_tt;
+    int64_t sum_tl;
+};
+
+struct battery_estimate {
+    int16_t rate_cph;  // 电量变化速率，0.01%/小时，放电为负
+    uint16_t eta_min;  // 预计剩余分钟数，BATTERY_ETA_UNKNOWN 表示无法估计
+};
+
+void battery_history_reset(struct battery_history *history);
+
+/*
+ * 加入一个样本，O(1)
+ *
+ * level 为 0（未连接）时忽略。电量明显上升（充电或换电池）时清空历史重新开始，
+ * 小幅回升（如重连后电压恢复）不记录；单次大幅下降的样本先丢弃，接近的电量连续出现时才认为是真实跳变
+ */
+void battery_history_add(struct battery_history *history, int64_t now_ms, uint8_t level);
+
+/* 根据窗口内的样本估计放电速率和剩余时间，O(1)；样本不足时返回 false */
+bool battery_history_estimate(const struct battery_history *history,
+                              struct battery_estimate *estimate);
@@ -1,26 +1,27 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
 #include <string.h>
 LOG_MODULE_REGISTER(bongo_cat_widget, LOG_LEVEL_DBG);
 
 #include <zmk/display.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/wpm_state_changed.h>
+#include <zmk/events/position_state_changed.h>
 #include <zmk/wpm.h>
 #include <lvgl.h>
 
 #include "bongo_cat.h"
 
+#if defined(CONFIG_DONGLE_SCREEN_BONGO_CAT_ASSET_SLOT) && CONFIG_DONGLE_SCREEN_BONGO_CAT_ASSET_SLOT >= 0
+#include "assets.h"
+#define ASSET_FIRST_SLOT CONFIG_DONGLE_SCREEN_BONGO_CAT_ASSET_SLOT
+#endif
+
 /* ================= 图片资源 ================= */
 
-LV_IMG_DECLARE(bongo_cat_none);
-LV_IMG_DECLARE(bongo_cat_left1);
-LV_IMG_DECLARE(bongo_cat_left2);
-LV_IMG_DECLARE(bongo_cat_right1);
-LV_IMG_DECLARE(bongo_cat_right2);
-LV_IMG_DECLARE(bongo_cat_both1);
-LV_IMG_DECLARE(bongo_cat_both1_open);
-LV_IMG_DECLARE(bongo_cat_both2);
+// 帧图片和帧之间的变化区域由 scripts/gen_bongo_cat_diff.py 生成
+#include "bongo_cat_diff.h"
 
 /* ================= 动画速度 ================= */
 
@@ -29,44 +30,52 @@ LV_IMG_DECLARE(bongo_cat_both2);
 #define ANIMATION_SPEED_MID  500
 #define ANIMATION_SPEED_FAST 200
 
+/* ================= 档位阈值 ================= */
+
+// idle->slow, slow->mid, mid->fast 的升档阈值（WPM）
+static const uint8_t wpm_thresholds[] = {5, 30, 75};
+
+// 降档要低于阈值这么多，WPM 在阈值附近波动时动画不会来回切换
+#define WPM_HYSTERESIS 3
+
 /* ================= 动画帧 ================= */
 
-static const lv_img_dsc_t *idle_imgs[] = {
-    &bongo_cat_both1_open,
-    &bongo_cat_both1_open,
-    &bongo_cat_both1_open,
-    &bongo_cat_both1,
+static const uint8_t idle_frames[] = {
+    BONGO_CAT_FRAME_BOTH1_OPEN,
+    BONGO_CAT_FRAME_BOTH1_OPEN,
+    BONGO_CAT_FRAME_BOTH1_OPEN,
+    BONGO_CAT_FRAME_BOTH1,
 };
 
-static const lv_img_dsc_t *slow_imgs[] = {
-    &bongo_cat_left1,
-    &bongo_cat_both1,
-    &bongo_cat_both1,
-    &bongo_cat_right1,
-    &bongo_cat_both1,
-    &bongo_cat_both1,
-    &bongo_cat_left1,
-    &bongo_cat_both1,
-    &bongo_cat_both1,
+static const uint8_t slow_frames[] = {
+    BONGO_CAT_FRAME_LEFT1,
+    BONGO_CAT_FRAME_BOTH1,
+    BONGO_CAT_FRAME_BOTH1,
+    BONGO_CAT_FRAME_RIGHT1,
+    BONGO_CAT_FRAME_BOTH1,
+    BONGO_CAT_FRAME_BOTH1,
+    BONGO_CAT_FRAME_LEFT1,
+    BONGO_CAT_FRAME_BOTH1,
+    BONGO_CAT_FRAME_BOTH1,
 };
 
-static const lv_img_dsc_t *mid_imgs[] = {
-    &bongo_cat_left2,
-    &bongo_cat_left1,
-    &bongo_cat_none,
-    &bongo_cat_right2,
-    &bongo_cat_right1,
-    &bongo_cat_none,
+static const uint8_t mid_frames[] = {
+    BONGO_CAT_FRAME_LEFT2,
+    BONGO_CAT_FRAME_LEFT1,
+    BONGO_CAT_FRAME_NONE,
+    BONGO_CAT_FRAME_RIGHT2,
+    BONGO_CAT_FRAME_RIGHT1,
+    BONGO_CAT_FRAME_NONE,
 };
 
-static const lv_img_dsc_t *fast_imgs[] = {
-    &bongo_cat_both2,
-    &bongo_cat_both1,
-    &bongo_cat_none,
-    &bongo_cat_none,
+static const uint8_t fast_frames[] = {
+    BONGO_CAT_FRAME_BOTH2,
+    BONGO_CAT_FRAME_BOTH1,
+    BONGO_CAT_FRAME_NONE,
+    BONGO_CAT_FRAME_NONE,
 };
 
-#define SRC(imgs) (const void **)imgs, sizeof(imgs) / sizeof(lv_img_dsc_t *)
+#define FRAMES(frames) frames, ARRAY_SIZE(frames)
 
 /* ================= 炫彩颜色表（FAST 专用） ================= */
 
@@ -92,13 +101,60 @@ struct bongo_cat_wpm_status_state {
 
 /* ================= 炫彩动画 ================= */
 
+/*
+ * 1 位索引图片：第 0 项为背景，第 1 项为线条。只有一套帧图片，
+ * 反色和主题色都通过改写调色板得到：
+ *   普通：背景透明，线条为主题色
+ *   反色：背景为主题色，线条为黑色
+ * 炫彩动画用彩虹色替换主题色
+ */
+#define PALETTE_BG 0
+#define PALETTE_INK 1
+#define COLOR_IDX_THEME 0xFF
+
+#define THEME_COLOR lv_color_hex(CONFIG_DONGLE_SCREEN_BONGO_CAT_COLOR)
+
+static void set_palette_entry(lv_img_dsc_t *img, uint8_t id, lv_color_t color, lv_opa_t opa) {
+    lv_color32_t *palette = (lv_color32_t *)img->data;
+    palette[id].full = lv_color_to32(color);
+    palette[id].ch.alpha = opa;
+}
+
+/*
+ * 改写所有帧副本的调色板；内置解码器打开图片时读取调色板，
+ * 需要让图片缓存失效，下次绘制时重新读取
+ */
+static void apply_palette(struct zmk_widget_bongo_cat *widget) {
+    lv_color_t color =
+        widget->color_idx == COLOR_IDX_THEME ? THEME_COLOR : fast_colors[widget->color_idx];
+
+    for (int i = 0; i < BONGO_CAT_FRAME_COUNT; i++) {
+        if (widget->inverted) {
+            set_palette_entry(&widget->imgs[i], PALETTE_BG, color, LV_OPA_COVER);
+            set_palette_entry(&widget->imgs[i], PALETTE_INK, lv_color_black(), LV_OPA_COVER);
+        } else {
+            set_palette_entry(&widget->imgs[i], PALETTE_BG, lv_color_black(), LV_OPA_TRANSP);
+            set_palette_entry(&widget->imgs[i], PALETTE_INK, color, LV_OPA_COVER);
+        }
+        lv_img_cache_invalidate_src(&widget->imgs[i]);
+    }
+
+    lv_obj_invalidate(widget->obj);
+}
+
+static void set_theme_color(struct zmk_widget_bongo_cat *widget, uint8_t color_idx) {
+    if (color_idx == widget->color_idx) {
+        return;
+    }
+    widget->color_idx = color_idx;
+    apply_palette(widget);
+}
+
 static void fast_color_anim_cb(void *obj, int32_t v) {
     lv_obj_t *o = (lv_obj_t*)obj;
     if (!o || !lv_obj_is_valid(o)) return;
     
-    uint32_t idx = v % FAST_COLOR_COUNT;
-    lv_obj_set_style_img_recolor(o, fast_colors[idx], 0);
-    lv_obj_set_style_img_recolor_opa(o, LV_OPA_COVER, 0);
+    set_theme_color(lv_obj_get_user_data(o), v % FAST_COLOR_COUNT);
 }
 
 static void start_fast_color_anim(lv_obj_t *obj) {
@@ -119,45 +175,165 @@ static void start_fast_color_anim(lv_obj_t *obj) {
 static void stop_fast_color_anim(lv_obj_t *obj) {
     if (!obj) return;
     lv_anim_del(obj, fast_color_anim_cb);
-    lv_obj_set_style_img_recolor_opa(obj, LV_OPA_0, 0);
+    set_theme_color(lv_obj_get_user_data(obj), COLOR_IDX_THEME);
 }
 
 /* ================= 动画切换逻辑 ================= */
 
-static void set_animation(lv_obj_t *anim_obj,
-                          struct bongo_cat_wpm_status_state state) {
+static enum anim_state wpm_to_state(enum anim_state current, uint8_t wpm) {
+    enum anim_state next = anim_state_idle;
+
+    for (int i = 0; i < ARRAY_SIZE(wpm_thresholds); i++) {
+        uint8_t threshold = wpm_thresholds[i];
+
+        // 已经在这个阈值之上的档位，需要低于 threshold - WPM_HYSTERESIS 才降档
+        if (current > anim_state_idle + i && threshold > WPM_HYSTERESIS) {
+            threshold -= WPM_HYSTERESIS;
+        }
+        if (wpm >= threshold) {
+            next = anim_state_idle + i + 1;
+        }
+    }
+    return next;
+}
+
+/* ================= 帧绘制 ================= */
+
+#ifdef ASSET_FIRST_SLOT
+// 帧 i 优先使用槽位 ASSET_FIRST_SLOT + i 中上传的图片，槽位为空或正在上传时返回 NULL
+static const lv_img_dsc_t *asset_frame(uint8_t frame) {
+    int slot = ASSET_FIRST_SLOT + frame;
+    return slot < assets_slot_count() ? assets_get_image(slot) : NULL;
+}
+#else
+static const lv_img_dsc_t *asset_frame(uint8_t frame) {
+    return NULL;
+}
+#endif
+
+static const lv_img_dsc_t *frame_image(struct zmk_widget_bongo_cat *widget, uint8_t frame) {
+    const lv_img_dsc_t *img = asset_frame(frame);
+    return img ? img : &widget->imgs[frame];
+}
+
+// 只画当前帧；LVGL 调用时裁剪区域已限制为被刷新的矩形
+static void bongo_cat_draw_cb(lv_event_t *e) {
+    lv_obj_t *obj = lv_event_get_target(e);
+    struct zmk_widget_bongo_cat *widget = lv_obj_get_user_data(obj);
+    lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+
+    const lv_img_dsc_t *img = frame_image(widget, widget->frame);
+
+    // 上传的图片可能与内置帧大小不同：从左上角画，超出对象的部分被裁掉
+    lv_area_t area = {
+        .x1 = obj->coords.x1,
+        .y1 = obj->coords.y1,
+        .x2 = obj->coords.x1 + img->header.w - 1,
+        .y2 = obj->coords.y1 + img->header.h - 1,
+    };
+
+    lv_draw_img_dsc_t dsc;
+    lv_draw_img_dsc_init(&dsc);
+    lv_obj_init_draw_img_dsc(obj, LV_PART_MAIN, &dsc);
+    lv_draw_img(draw_ctx, &dsc, &area, img);
+}
+
+// 切换帧时只刷新与上一帧不同的矩形，而不是整个 50x26 的图片
+static void show_frame(struct zmk_widget_bongo_cat *widget, uint8_t frame) {
+    if (frame == widget->frame) {
+        return;
+    }
+
+    // 变化区域只对内置帧有效，涉及上传的帧时刷新整个对象
+    if (asset_frame(widget->frame) || asset_frame(frame)) {
+        widget->frame = frame;
+        lv_obj_invalidate(widget->obj);
+        return;
+    }
+
+    const struct bongo_cat_rect *rects = bongo_cat_diff[widget->frame][frame];
+    lv_area_t *coords = &widget->obj->coords;
+
+    widget->frame = frame;
+
+    for (int i = 0; i < BONGO_CAT_DIFF_RECTS; i++) {
+        if (rects[i].x2 < rects[i].x1) {
+            continue;
+        }
+        lv_area_t area = {
+            .x1 = coords->x1 + rects[i].x1,
+            .y1 = coords->y1 + rects[i].y1,
+            .x2 = coords->x1 + rects[i].x2,
+            .y2 = coords->y1 + rects[i].y2,
+        };
+        lv_obj_invalidate_area(widget->obj, &area);
+    }
+}
+
+static void frame_anim_cb(void *var, int32_t v) {
+    lv_obj_t *obj = var;
+    struct zmk_widget_bongo_cat *widget = lv_obj_get_user_data(obj);
+
+    // 动画值走到 frame_count 时正好结束一轮，取模回到第 0 帧
+    show_frame(widget, widget->frames[v % widget->frame_count]);
+}
+
+// 与 lv_animimg 相同：duration 为一整轮的时间，每帧平均分配
+static void start_animation(struct zmk_widget_bongo_cat *widget, const uint8_t *frames,
+                            uint8_t count, uint32_t duration) {
+    lv_anim_del(widget->obj, frame_anim_cb);
+
+    widget->frames = frames;
+    widget->frame_count = count;
+    show_frame(widget, frames[0]);
+
+    lv_anim_t anim;
+    lv_anim_init(&anim);
+    lv_anim_set_var(&anim, widget->obj);
+    lv_anim_set_exec_cb(&anim, frame_anim_cb);
+    lv_anim_set_values(&anim, 0, count);
+    lv_anim_set_time(&anim, duration);
+    lv_anim_set_repeat_count(&anim, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_start(&anim);
+}
+
+/*
+ * 只在档位变化时切换动画；同一档位内的 WPM 事件不做任何事，
+ * 动画帧和炫彩动画都继续运行，不会回到第 0 帧，也不会重绘整个 widget
+ */
+static void set_animation(struct zmk_widget_bongo_cat *widget, uint8_t wpm) {
+    lv_obj_t *anim_obj = widget->obj;
     if (!anim_obj || !lv_obj_is_valid(anim_obj)) return;
 
-    /* 停止当前动画 */
-    stop_fast_color_anim(anim_obj);
-
-    if (state.wpm < 5) {
-        lv_animimg_set_src(anim_obj, SRC(idle_imgs));
-        lv_animimg_set_duration(anim_obj, ANIMATION_SPEED_IDLE);
-        lv_animimg_set_repeat_count(anim_obj, LV_ANIM_REPEAT_INFINITE);
-        lv_animimg_start(anim_obj);
-
-    } else if (state.wpm < 30) {
-        lv_animimg_set_src(anim_obj, SRC(slow_imgs));
-        lv_animimg_set_duration(anim_obj, ANIMATION_SPEED_SLOW);
-        lv_animimg_set_repeat_count(anim_obj, LV_ANIM_REPEAT_INFINITE);
-        lv_animimg_start(anim_obj);
-
-    } else if (state.wpm < 75) {
-        lv_animimg_set_src(anim_obj, SRC(mid_imgs));
-        lv_animimg_set_duration(anim_obj, ANIMATION_SPEED_MID);
-        lv_animimg_set_repeat_count(anim_obj, LV_ANIM_REPEAT_INFINITE);
-        lv_animimg_start(anim_obj);
-
-    } else {
-        lv_animimg_set_src(anim_obj, SRC(fast_imgs));
-        lv_animimg_set_duration(anim_obj, ANIMATION_SPEED_FAST);
-        lv_animimg_set_repeat_count(anim_obj, LV_ANIM_REPEAT_INFINITE);
-        lv_animimg_start(anim_obj);
+    enum anim_state state = wpm_to_state(widget->state, wpm);
+    if (state == widget->state) {
+        return;
+    }
 
+    /* 离开 FAST 时停止炫彩动画 */
+    if (widget->state == anim_state_fast) {
+        stop_fast_color_anim(anim_obj);
+    }
+
+    switch (state) {
+    case anim_state_slow:
+        start_animation(widget, FRAMES(slow_frames), ANIMATION_SPEED_SLOW);
+        break;
+    case anim_state_mid:
+        start_animation(widget, FRAMES(mid_frames), ANIMATION_SPEED_MID);
+        break;
+    case anim_state_fast:
+        start_animation(widget, FRAMES(fast_frames), ANIMATION_SPEED_FAST);
         /* FAST 模式启动炫彩动画 */
         start_fast_color_anim(anim_obj);
+        break;
+    default:
+        start_animation(widget, FRAMES(idle_frames), ANIMATION_SPEED_IDLE);
+        break;
     }
+
+    LOG_DBG("bongo cat 档位 %d -> %d (wpm %u)", widget->state, state, wpm);
+    widget->state = state;
 }
 
 /* ================= ZMK 事件 ================= */
@@ -172,10 +348,15 @@ bongo_cat_wpm_status_get_state(const zmk_event_t *eh) {
 }
 
 void bongo_cat_wpm_status_update_cb(struct bongo_cat_wpm_status_state state) {
+    // 按键同步模式下爪子跟随按键，不按 WPM 切换档位
+    if (IS_ENABLED(CONFIG_DONGLE_SCREEN_BONGO_CAT_KEYSYNC)) {
+        return;
+    }
+
     struct zmk_widget_bongo_cat *widget;
     SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
         if (widget && widget->obj) {
-            set_animation(widget->obj, state);
+            set_animation(widget, state.wpm);
         }
     }
 }
@@ -189,6 +370,144 @@ ZMK_DISPLAY_WIDGET_LISTENER(
 
 ZMK_SUBSCRIPTION(widget_bongo_cat, zmk_wpm_state_changed);
 
+/* ================= 上传的帧 ================= */
+
+#ifdef ASSET_FIRST_SLOT
+
+/*
+ * 在显示工作队列中触发。上传开始时槽位已失效，刷新后改画内置帧，
+ * 不会再读正在擦写的 flash；提交后刷新画出新图片
+ */
+static int asset_changed_listener(const zmk_event_t *eh) {
+    const struct dongle_asset_changed *ev = as_dongle_asset_changed(eh);
+    if (!ev) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    int frame = ev->slot - ASSET_FIRST_SLOT;
+    if (frame < 0 || frame >= BONGO_CAT_FRAME_COUNT) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    struct zmk_widget_bongo_cat *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        if (widget->obj && lv_obj_is_valid(widget->obj)) {
+            lv_obj_invalidate(widget->obj);
+        }
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(widget_bongo_cat_assets, asset_changed_listener);
+ZMK_SUBSCRIPTION(widget_bongo_cat_assets, dongle_asset_changed);
+
+#endif
+
+/* ================= 按键同步模式 ================= */
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BONGO_CAT_KEYSYNC)
+
+#define KEYSYNC_ROW_WIDTH CONFIG_DONGLE_SCREEN_BONGO_CAT_KEYSYNC_ROW_WIDTH
+#define KEYSYNC_LEFT_COLUMNS                                                                       \
+    (CONFIG_DONGLE_SCREEN_BONGO_CAT_KEYSYNC_LEFT_COLUMNS > 0                                       \
+         ? CONFIG_DONGLE_SCREEN_BONGO_CAT_KEYSYNC_LEFT_COLUMNS                                     \
+         : KEYSYNC_ROW_WIDTH / 2)
+
+// 每次按键让对应的爪子在两个姿势之间切换一次
+static const uint8_t keysync_paw_frames[2][2] = {
+    {BONGO_CAT_FRAME_LEFT1, BONGO_CAT_FRAME_LEFT2},
+    {BONGO_CAT_FRAME_RIGHT1, BONGO_CAT_FRAME_RIGHT2},
+};
+
+static uint8_t keysync_paw_pose[2];
+
+// 最新一次按键对应的帧，连续按键时只保留最后一个
+static atomic_t keysync_frame = ATOMIC_INIT(BONGO_CAT_FRAME_BOTH1);
+// 上次换帧的时间（k_uptime_get_32），用于把换帧限制在屏幕刷新周期内
+static atomic_t keysync_last_ms = ATOMIC_INIT(0);
+
+/*
+ * 左爪返回 0，右爪返回 1
+ *
+ * 配置了每行按键数时按列判断（按键位置按行排列），否则按事件来源判断：
+ * 第一个分体（通常是左半）为左爪，其余为右爪，dongle 本机的按键算左爪
+ */
+static int keysync_side(const struct zmk_position_state_changed *ev) {
+#if KEYSYNC_ROW_WIDTH > 0
+    return (ev->position % KEYSYNC_ROW_WIDTH) < KEYSYNC_LEFT_COLUMNS ? 0 : 1;
+#else
+    if (ev->source == ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL) {
+        return 0;
+    }
+    return ev->source == 0 ? 0 : 1;
+#endif
+}
+
+static void keysync_work_handler(struct k_work *work) {
+    uint8_t frame = atomic_get(&keysync_frame);
+    atomic_set(&keysync_last_ms, k_uptime_get_32());
+
+    struct zmk_widget_bongo_cat *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        if (!widget->obj || !lv_obj_is_valid(widget->obj)) {
+            continue;
+        }
+        // 停止空闲动画，爪子只随按键移动
+        if (widget->state != anim_state_none) {
+            lv_anim_del(widget->obj, frame_anim_cb);
+            widget->state = anim_state_none;
+        }
+        show_frame(widget, frame);
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(keysync_work, keysync_work_handler);
+
+// 一段时间没有按键后回到空闲动画
+static void keysync_idle_work_handler(struct k_work *work) {
+    struct zmk_widget_bongo_cat *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        if (widget->obj && lv_obj_is_valid(widget->obj)) {
+            set_animation(widget, 0);
+        }
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(keysync_idle_work, keysync_idle_work_handler);
+
+/*
+ * 在触发事件的线程中运行，只记录最新的帧并安排显示队列上的工作。
+ * 工作已在等待时 k_work_schedule 不做任何事，连续按键合并为一次换帧，
+ * 不会在显示队列里堆积重绘
+ */
+static int keysync_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (!ev || !ev->state) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    int side = keysync_side(ev);
+    keysync_paw_pose[side] ^= 1;
+    atomic_set(&keysync_frame, keysync_paw_frames[side][keysync_paw_pose[side]]);
+
+    // 距上次换帧不到一个刷新周期时推迟到下一个周期
+    uint32_t elapsed = k_uptime_get_32() - (uint32_t)atomic_get(&keysync_last_ms);
+    uint32_t delay = elapsed < CONFIG_LV_DISP_DEF_REFR_PERIOD
+                         ? CONFIG_LV_DISP_DEF_REFR_PERIOD - elapsed
+                         : 0;
+
+    k_work_schedule_for_queue(zmk_display_work_q(), &keysync_work, K_MSEC(delay));
+    k_work_reschedule_for_queue(zmk_display_work_q(), &keysync_idle_work,
+                                K_MSEC(CONFIG_DONGLE_SCREEN_BONGO_CAT_KEYSYNC_IDLE_MS));
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(widget_bongo_cat_keysync, keysync_listener);
+ZMK_SUBSCRIPTION(widget_bongo_cat_keysync, zmk_position_state_changed);
+
+#endif
+
 /* ================= 初始化 ================= */
 
 int zmk_widget_bongo_cat_init(struct zmk_widget_bongo_cat *widget,
@@ -204,17 +523,36 @@ int zmk_widget_bongo_cat_init(struct zmk_widget_bongo_cat *widget,
         return 0;
     }
     
-    widget->obj = lv_animimg_create(parent);
+    widget->obj = lv_obj_create(parent);
     if (!widget->obj) {
-        LOG_ERR("创建动画图像失败");
+        LOG_ERR("创建动画对象失败");
         return -ENOMEM;
     }
+
+    // 自绘对象：没有背景和边框，大小与帧图片相同
+    const lv_img_dsc_t *first = bongo_cat_frames[idle_frames[0]];
+    lv_obj_remove_style_all(widget->obj);
+    lv_obj_clear_flag(widget->obj, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_size(widget->obj, first->header.w, first->header.h);
+    lv_obj_set_user_data(widget->obj, widget);
+    lv_obj_add_event_cb(widget->obj, bongo_cat_draw_cb, LV_EVENT_DRAW_MAIN, NULL);
+    widget->frame = idle_frames[0];
+
+    // 复制帧数据到 RAM，调色板可以改写
+    for (int i = 0; i < BONGO_CAT_FRAME_COUNT; i++) {
+        memcpy(widget->img_data[i], bongo_cat_frames[i]->data, BONGO_CAT_FRAME_DATA_SIZE);
+        widget->imgs[i] = *bongo_cat_frames[i];
+        widget->imgs[i].data = widget->img_data[i];
+    }
+    widget->color_idx = COLOR_IDX_THEME;
+    widget->inverted = IS_ENABLED(CONFIG_DONGLE_SCREEN_BONGO_CAT_INVERTED);
+    apply_palette(widget);
     
     lv_obj_center(widget->obj);
     
     // 初始化为空闲状态
-    struct bongo_cat_wpm_status_state init_state = { .wpm = 0 };
-    set_animation(widget->obj, init_state);
+    widget->state = anim_state_none;
+    set_animation(widget, 0);
     
     sys_slist_append(&widgets, &widget->node);
     widget_bongo_cat_init();
@@ -233,8 +571,16 @@ void zmk_widget_bongo_cat_set_wpm(struct zmk_widget_bongo_cat *widget,
         return;
     }
     
-    struct bongo_cat_wpm_status_state state = {.wpm = wpm};
-    set_animation(widget->obj, state);
+    set_animation(widget, wpm);
+}
+
+void zmk_widget_bongo_cat_set_inverted(struct zmk_widget_bongo_cat *widget, bool inverted) {
+    if (!widget || !widget->obj || widget->inverted == inverted) {
+        return;
+    }
+
+    widget->inverted = inverted;
+    apply_palette(widget);
 }
 
 /* ================= 销毁函数 ================= */
@@ -262,10 +608,11 @@ void zmk_widget_bongo_cat_destroy(struct zmk_widget_bongo_cat *widget) {
     
     // 停止并销毁动画对象
     if (widget->obj && lv_obj_is_valid(widget->obj)) {
-        // 不需要调用 lv_animimg_stop，直接删除对象即可
+        // 帧动画随对象一起删除
         stop_fast_color_anim(widget->obj);
         lv_obj_del(widget->obj);
         widget->obj = NULL;
+        widget->state = anim_state_none;
     }
 }
 
@@ -4,6 +4,8 @@
 #include <zephyr/kernel.h>
 #include <lvgl.h>
 
+#include "bongo_cat_diff.h"
+
 // 动画状态枚举
 enum anim_state {
     anim_state_none,
@@ -16,10 +18,26 @@ enum anim_state {
 struct zmk_widget_bongo_cat {
     lv_obj_t *obj;
     sys_snode_t node;
+    enum anim_state state;  // 当前运行的动画档位
+
+    const uint8_t *frames;  // 当前档位的帧序列（enum bongo_cat_frame）
+    uint8_t frame_count;
+    uint8_t frame;          // 正在显示的帧
+
+    /*
+     * 帧数据的 RAM 副本，反色、主题色和炫彩动画都直接改写调色板，
+     * 每个 widget 各有一份，互不影响
+     */
+    lv_img_dsc_t imgs[BONGO_CAT_FRAME_COUNT];
+    uint8_t img_data[BONGO_CAT_FRAME_COUNT][BONGO_CAT_FRAME_DATA_SIZE];
+    uint8_t color_idx;      // 当前主题色在 fast_colors 中的下标，0xFF 为配置的主题色
+    bool inverted;
 };
 
 int zmk_widget_bongo_cat_init(struct zmk_widget_bongo_cat *widget, lv_obj_t *parent);
 lv_obj_t *zmk_widget_bongo_cat_obj(struct zmk_widget_bongo_cat *widget);
 void zmk_widget_bongo_cat_set_wpm(struct zmk_widget_bongo_cat *widget, uint8_t wpm);
+// 运行时切换反色显示，不需要第二套图片
+void zmk_widget_bongo_cat_set_inverted(struct zmk_widget_bongo_cat *widget, bool inverted);
 
 #endif /* ZMK_WIDGET_BONGO_CAT_H */
\ No newline at end of file
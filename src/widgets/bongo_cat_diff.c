@@ -0,0 +1,111 @@
+/*
+ * 由 scripts/gen_bongo_cat_diff.py 从 bongo_cat_images.c 生成，不要手动修改
+ * FAST 档每秒刷新像素：整帧 26000，按矩形 2740
+ */
+
+#include <lvgl.h>
+#include "bongo_cat_diff.h"
+
+LV_IMG_DECLARE(bongo_cat_none);
+LV_IMG_DECLARE(bongo_cat_left1);
+LV_IMG_DECLARE(bongo_cat_left2);
+LV_IMG_DECLARE(bongo_cat_right1);
+LV_IMG_DECLARE(bongo_cat_right2);
+LV_IMG_DECLARE(bongo_cat_both1);
+LV_IMG_DECLARE(bongo_cat_both1_open);
+LV_IMG_DECLARE(bongo_cat_both2);
+
+const lv_img_dsc_t *const bongo_cat_frames[BONGO_CAT_FRAME_COUNT] = {
+    [BONGO_CAT_FRAME_NONE] = &bongo_cat_none,
+    [BONGO_CAT_FRAME_LEFT1] = &bongo_cat_left1,
+    [BONGO_CAT_FRAME_LEFT2] = &bongo_cat_left2,
+    [BONGO_CAT_FRAME_RIGHT1] = &bongo_cat_right1,
+    [BONGO_CAT_FRAME_RIGHT2] = &bongo_cat_right2,
+    [BONGO_CAT_FRAME_BOTH1] = &bongo_cat_both1,
+    [BONGO_CAT_FRAME_BOTH1_OPEN] = &bongo_cat_both1_open,
+    [BONGO_CAT_FRAME_BOTH2] = &bongo_cat_both2,
+};
+
+const struct bongo_cat_rect
+    bongo_cat_diff[BONGO_CAT_FRAME_COUNT][BONGO_CAT_FRAME_COUNT][BONGO_CAT_DIFF_RECTS] = {
+    [BONGO_CAT_FRAME_NONE] = {
+        [BONGO_CAT_FRAME_NONE] = {{1, 0, 0, 0}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_LEFT1] = {{9, 7, 18, 18}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_LEFT2] = {{9, 7, 18, 21}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_RIGHT1] = {{28, 12, 35, 21}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_RIGHT2] = {{26, 12, 35, 24}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_BOTH1] = {{9, 7, 18, 18}, {28, 12, 35, 21}},
+        [BONGO_CAT_FRAME_BOTH1_OPEN] = {{9, 7, 21, 18}, {26, 11, 35, 21}},
+        [BONGO_CAT_FRAME_BOTH2] = {{9, 7, 18, 21}, {26, 12, 35, 24}},
+    },
+    [BONGO_CAT_FRAME_LEFT1] = {
+        [BONGO_CAT_FRAME_NONE] = {{9, 7, 18, 18}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_LEFT1] = {{1, 0, 0, 0}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_LEFT2] = {{9, 18, 16, 21}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_RIGHT1] = {{9, 7, 18, 18}, {28, 12, 35, 21}},
+        [BONGO_CAT_FRAME_RIGHT2] = {{9, 7, 18, 18}, {26, 12, 35, 24}},
+        [BONGO_CAT_FRAME_BOTH1] = {{28, 12, 35, 21}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_BOTH1_OPEN] = {{19, 10, 21, 11}, {26, 11, 35, 21}},
+        [BONGO_CAT_FRAME_BOTH2] = {{9, 18, 16, 21}, {26, 12, 35, 24}},
+    },
+    [BONGO_CAT_FRAME_LEFT2] = {
+        [BONGO_CAT_FRAME_NONE] = {{9, 7, 18, 21}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_LEFT1] = {{9, 18, 16, 21}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_LEFT2] = {{1, 0, 0, 0}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_RIGHT1] = {{9, 7, 18, 21}, {28, 12, 35, 21}},
+        [BONGO_CAT_FRAME_RIGHT2] = {{9, 7, 18, 21}, {26, 12, 35, 24}},
+        [BONGO_CAT_FRAME_BOTH1] = {{9, 18, 16, 21}, {28, 12, 35, 21}},
+        [BONGO_CAT_FRAME_BOTH1_OPEN] = {{9, 10, 21, 21}, {26, 11, 35, 21}},
+        [BONGO_CAT_FRAME_BOTH2] = {{26, 12, 35, 24}, {1, 0, 0, 0}},
+    },
+    [BONGO_CAT_FRAME_RIGHT1] = {
+        [BONGO_CAT_FRAME_NONE] = {{28, 12, 35, 21}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_LEFT1] = {{9, 7, 18, 18}, {28, 12, 35, 21}},
+        [BONGO_CAT_FRAME_LEFT2] = {{9, 7, 18, 21}, {28, 12, 35, 21}},
+        [BONGO_CAT_FRAME_RIGHT1] = {{1, 0, 0, 0}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_RIGHT2] = {{26, 21, 34, 24}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_BOTH1] = {{9, 7, 18, 18}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_BOTH1_OPEN] = {{9, 7, 21, 18}, {26, 11, 28, 12}},
+        [BONGO_CAT_FRAME_BOTH2] = {{9, 7, 18, 21}, {26, 21, 34, 24}},
+    },
+    [BONGO_CAT_FRAME_RIGHT2] = {
+        [BONGO_CAT_FRAME_NONE] = {{26, 12, 35, 24}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_LEFT1] = {{9, 7, 18, 18}, {26, 12, 35, 24}},
+        [BONGO_CAT_FRAME_LEFT2] = {{9, 7, 18, 21}, {26, 12, 35, 24}},
+        [BONGO_CAT_FRAME_RIGHT1] = {{26, 21, 34, 24}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_RIGHT2] = {{1, 0, 0, 0}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_BOTH1] = {{9, 7, 18, 18}, {26, 21, 34, 24}},
+        [BONGO_CAT_FRAME_BOTH1_OPEN] = {{9, 7, 21, 18}, {26, 11, 34, 24}},
+        [BONGO_CAT_FRAME_BOTH2] = {{9, 7, 18, 21}, {1, 0, 0, 0}},
+    },
+    [BONGO_CAT_FRAME_BOTH1] = {
+        [BONGO_CAT_FRAME_NONE] = {{9, 7, 18, 18}, {28, 12, 35, 21}},
+        [BONGO_CAT_FRAME_LEFT1] = {{28, 12, 35, 21}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_LEFT2] = {{9, 18, 16, 21}, {28, 12, 35, 21}},
+        [BONGO_CAT_FRAME_RIGHT1] = {{9, 7, 18, 18}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_RIGHT2] = {{9, 7, 18, 18}, {26, 21, 34, 24}},
+        [BONGO_CAT_FRAME_BOTH1] = {{1, 0, 0, 0}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_BOTH1_OPEN] = {{19, 10, 21, 11}, {26, 11, 28, 12}},
+        [BONGO_CAT_FRAME_BOTH2] = {{9, 18, 16, 21}, {26, 21, 34, 24}},
+    },
+    [BONGO_CAT_FRAME_BOTH1_OPEN] = {
+        [BONGO_CAT_FRAME_NONE] = {{9, 7, 21, 18}, {26, 11, 35, 21}},
+        [BONGO_CAT_FRAME_LEFT1] = {{19, 10, 21, 11}, {26, 11, 35, 21}},
+        [BONGO_CAT_FRAME_LEFT2] = {{9, 10, 21, 21}, {26, 11, 35, 21}},
+        [BONGO_CAT_FRAME_RIGHT1] = {{9, 7, 21, 18}, {26, 11, 28, 12}},
+        [BONGO_CAT_FRAME_RIGHT2] = {{9, 7, 21, 18}, {26, 11, 34, 24}},
+        [BONGO_CAT_FRAME_BOTH1] = {{19, 10, 21, 11}, {26, 11, 28, 12}},
+        [BONGO_CAT_FRAME_BOTH1_OPEN] = {{1, 0, 0, 0}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_BOTH2] = {{9, 10, 21, 21}, {26, 11, 34, 24}},
+    },
+    [BONGO_CAT_FRAME_BOTH2] = {
+        [BONGO_CAT_FRAME_NONE] = {{9, 7, 18, 21}, {26, 12, 35, 24}},
+        [BONGO_CAT_FRAME_LEFT1] = {{9, 18, 16, 21}, {26, 12, 35, 24}},
+        [BONGO_CAT_FRAME_LEFT2] = {{26, 12, 35, 24}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_RIGHT1] = {{9, 7, 18, 21}, {26, 21, 34, 24}},
+        [BONGO_CAT_FRAME_RIGHT2] = {{9, 7, 18, 21}, {1, 0, 0, 0}},
+        [BONGO_CAT_FRAME_BOTH1] = {{9, 18, 16, 21}, {26, 21, 34, 24}},
+        [BONGO_CAT_FRAME_BOTH1_OPEN] = {{9, 10, 21, 21}, {26, 11, 34, 24}},
+        [BONGO_CAT_FRAME_BOTH2] = {{1, 0, 0, 0}, {1, 0, 0, 0}},
+    },
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+/* 由 scripts/gen_bongo_cat_diff.py 从 bongo_cat_images.c 生成，不要手动修改 */
+
+#include <stdint.h>
+#include <lvgl.h>
+
+enum bongo_cat_frame {
+    BONGO_CAT_FRAME_NONE,
+    BONGO_CAT_FRAME_LEFT1,
+    BONGO_CAT_FRAME_LEFT2,
+    BONGO_CAT_FRAME_RIGHT1,
+    BONGO_CAT_FRAME_RIGHT2,
+    BONGO_CAT_FRAME_BOTH1,
+    BONGO_CAT_FRAME_BOTH1_OPEN,
+    BONGO_CAT_FRAME_BOTH2,
+    BONGO_CAT_FRAME_COUNT,
+};
+
+#define BONGO_CAT_DIFF_RECTS 2
+
+/* 每帧的数据大小（2 色调色板 + 1 位像素） */
+#define BONGO_CAT_FRAME_DATA_SIZE 190
+
+/* 相对图片左上角的矩形，包含两端；x2 < x1 表示未使用 */
+struct bongo_cat_rect {
+    uint8_t x1, y1, x2, y2;
+};
+
+extern const lv_img_dsc_t *const bongo_cat_frames[BONGO_CAT_FRAME_COUNT];
+
+/* bongo_cat_diff[从][到]：两帧之间变化的区域 */
+extern const struct bongo_cat_rect
+    bongo_cat_diff[BONGO_CAT_FRAME_COUNT][BONGO_CAT_FRAME_COUNT][BONGO_CAT_DIFF_RECTS];
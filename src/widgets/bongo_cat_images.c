@@ -16,8 +16,8 @@
 #endif
 
 const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_NONE uint8_t bongo_cat_none_map[] = {
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
-  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
 
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
   0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
@@ -62,8 +62,8 @@ const lv_img_dsc_t bongo_cat_none = {
 #endif
 
 const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_LEFT1 uint8_t bongo_cat_left1_map[] = {
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
-  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
 
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
   0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
@@ -108,8 +108,8 @@ const lv_img_dsc_t bongo_cat_left1 = {
 #endif
 
 const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_LEFT2 uint8_t bongo_cat_left2_map[] = {
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
-  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
 
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
   0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
@@ -154,8 +154,8 @@ const lv_img_dsc_t bongo_cat_left2 = {
 #endif
 
 const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_RIGHT1 uint8_t bongo_cat_right1_map[] = {
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
-  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
 
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
   0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
@@ -200,8 +200,8 @@ const lv_img_dsc_t bongo_cat_right1 = {
 #endif
 
 const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_RIGHT2 uint8_t bongo_cat_right2_map[] = {
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
-  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
 
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
   0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
@@ -246,8 +246,8 @@ const lv_img_dsc_t bongo_cat_right2 = {
 #endif
 
 const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH1 uint8_t bongo_cat_both1_map[] = {
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
-  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
 
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
   0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
@@ -292,8 +292,8 @@ const lv_img_dsc_t bongo_cat_both1 = {
 #endif
 
 const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH1_OPEN uint8_t bongo_cat_both1_open_map[] = {
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
-  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
 
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
   0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
@@ -338,8 +338,8 @@ const lv_img_dsc_t bongo_cat_both1_open = {
 #endif
 
 const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH2 uint8_t bongo_cat_both2_map[] = {
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
-  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
 
   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
   0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
@@ -377,4 +377,7 @@ const lv_img_dsc_t bongo_cat_both2 = {
   .header.h = 26,
   .data_size = 190,
   .data = bongo_cat_both2_map,
-};
\ No newline at end of file
+};
+
+
+
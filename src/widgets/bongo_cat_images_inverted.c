@@ -1,383 +0,0 @@
-/*
- * Copyright (c) 2024 The ZMK Contributors
- *
- * SPDX-License-Identifier: MIT
- */
- 
- #include <lvgl.h>
-
-
-#ifndef LV_ATTRIBUTE_MEM_ALIGN
-#define LV_ATTRIBUTE_MEM_ALIGN
-#endif
-
-#ifndef LV_ATTRIBUTE_IMG_BONGO_CAT_NONE
-#define LV_ATTRIBUTE_IMG_BONGO_CAT_NONE
-#endif
-
-const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_NONE uint8_t bongo_cat_none_map[] = {
-  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
-
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x18, 0x7c, 0x02, 0x00, 0x00, 
-  0x00, 0x00, 0x20, 0x07, 0xc5, 0x00, 0x00, 
-  0x00, 0x00, 0x40, 0x00, 0x79, 0x00, 0x00, 
-  0x00, 0x18, 0x80, 0x00, 0x11, 0x00, 0x00, 
-  0x00, 0x24, 0x80, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x43, 0x00, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x40, 0x08, 0x00, 0x02, 0x00, 0x00, 
-  0x00, 0x40, 0x14, 0x10, 0x02, 0x00, 0x00, 
-  0xe0, 0x20, 0x00, 0x29, 0x82, 0x00, 0x00, 
-  0x1f, 0x10, 0x01, 0x02, 0x41, 0x00, 0x00, 
-  0x00, 0xfc, 0x03, 0x84, 0x21, 0x80, 0x00, 
-  0x00, 0x03, 0xe0, 0x04, 0x10, 0x80, 0x00, 
-  0x00, 0x00, 0x1f, 0x84, 0x00, 0x80, 0x00, 
-  0x00, 0x00, 0x00, 0x7e, 0x00, 0xc0, 0x00, 
-  0x00, 0x00, 0x00, 0x03, 0xf0, 0x40, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x0f, 0xe0, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xc0, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-};
-
-const lv_img_dsc_t bongo_cat_none = {
-  .header.cf = LV_IMG_CF_INDEXED_1BIT,
-  .header.always_zero = 0,
-  .header.reserved = 0,
-  .header.w = 50,
-  .header.h = 26,
-  .data_size = 190,
-  .data = bongo_cat_none_map,
-};
-
-#ifndef LV_ATTRIBUTE_IMG_BONGO_CAT_LEFT1
-#define LV_ATTRIBUTE_IMG_BONGO_CAT_LEFT1
-#endif
-
-const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_LEFT1 uint8_t bongo_cat_left1_map[] = {
-  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
-
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x18, 0x7c, 0x02, 0x00, 0x00, 
-  0x00, 0x00, 0x20, 0x07, 0xc5, 0x00, 0x00, 
-  0x00, 0x00, 0x40, 0x00, 0x79, 0x00, 0x00, 
-  0x00, 0x00, 0x80, 0x00, 0x11, 0x00, 0x00, 
-  0x00, 0x00, 0x80, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x01, 0x08, 0x00, 0x02, 0x00, 0x00, 
-  0x00, 0x02, 0x14, 0x10, 0x02, 0x00, 0x00, 
-  0xe0, 0x04, 0x00, 0x29, 0x82, 0x00, 0x00, 
-  0x1f, 0x08, 0x01, 0x02, 0x41, 0x00, 0x00, 
-  0x00, 0xf0, 0x03, 0x84, 0x21, 0x80, 0x00, 
-  0x00, 0x10, 0x20, 0x04, 0x10, 0x80, 0x00, 
-  0x00, 0x10, 0x7f, 0x84, 0x00, 0x80, 0x00, 
-  0x00, 0x09, 0x80, 0x7e, 0x00, 0xc0, 0x00, 
-  0x00, 0x06, 0x00, 0x03, 0xf0, 0x40, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x0f, 0xe0, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xc0, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-};
-
-const lv_img_dsc_t bongo_cat_left1 = {
-  .header.cf = LV_IMG_CF_INDEXED_1BIT,
-  .header.always_zero = 0,
-  .header.reserved = 0,
-  .header.w = 50,
-  .header.h = 26,
-  .data_size = 190,
-  .data = bongo_cat_left1_map,
-};
-
-#ifndef LV_ATTRIBUTE_IMG_BONGO_CAT_LEFT2
-#define LV_ATTRIBUTE_IMG_BONGO_CAT_LEFT2
-#endif
-
-const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_LEFT2 uint8_t bongo_cat_left2_map[] = {
-  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
-
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x18, 0x7c, 0x02, 0x00, 0x00, 
-  0x00, 0x00, 0x20, 0x07, 0xc5, 0x00, 0x00, 
-  0x00, 0x00, 0x40, 0x00, 0x79, 0x00, 0x00, 
-  0x00, 0x00, 0x80, 0x00, 0x11, 0x00, 0x00, 
-  0x00, 0x00, 0x80, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x01, 0x08, 0x00, 0x02, 0x00, 0x00, 
-  0x00, 0x02, 0x14, 0x10, 0x02, 0x00, 0x00, 
-  0xe0, 0x04, 0x00, 0x29, 0x82, 0x00, 0x00, 
-  0x1f, 0x08, 0x01, 0x02, 0x41, 0x00, 0x00, 
-  0x00, 0xf0, 0x03, 0x84, 0x21, 0x80, 0x00, 
-  0x00, 0x10, 0x20, 0x04, 0x10, 0x80, 0x00, 
-  0x00, 0x10, 0x7f, 0x84, 0x00, 0x80, 0x00, 
-  0x00, 0x09, 0x80, 0x7e, 0x00, 0xc0, 0x00, 
-  0x00, 0x66, 0x00, 0x03, 0xf0, 0x40, 0x00, 
-  0x00, 0x40, 0x80, 0x00, 0x0f, 0xe0, 0x00, 
-  0x00, 0x04, 0x80, 0x00, 0x00, 0x3e, 0x00, 
-  0x00, 0x0c, 0x00, 0x00, 0x00, 0x01, 0xc0, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-};
-
-const lv_img_dsc_t bongo_cat_left2 = {
-  .header.cf = LV_IMG_CF_INDEXED_1BIT,
-  .header.always_zero = 0,
-  .header.reserved = 0,
-  .header.w = 50,
-  .header.h = 26,
-  .data_size = 190,
-  .data = bongo_cat_left2_map,
-};
-
-#ifndef LV_ATTRIBUTE_IMG_BONGO_CAT_RIGHT1
-#define LV_ATTRIBUTE_IMG_BONGO_CAT_RIGHT1
-#endif
-
-const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_RIGHT1 uint8_t bongo_cat_right1_map[] = {
-  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
-
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x18, 0x7c, 0x02, 0x00, 0x00, 
-  0x00, 0x00, 0x20, 0x07, 0xc5, 0x00, 0x00, 
-  0x00, 0x00, 0x40, 0x00, 0x79, 0x00, 0x00, 
-  0x00, 0x18, 0x80, 0x00, 0x11, 0x00, 0x00, 
-  0x00, 0x24, 0x80, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x43, 0x00, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x40, 0x08, 0x00, 0x02, 0x00, 0x00, 
-  0x00, 0x40, 0x14, 0x10, 0x02, 0x00, 0x00, 
-  0xe0, 0x20, 0x00, 0x28, 0x02, 0x00, 0x00, 
-  0x1f, 0x10, 0x01, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0xfc, 0x03, 0x80, 0x01, 0x80, 0x00, 
-  0x00, 0x03, 0xe0, 0x00, 0x00, 0x80, 0x00, 
-  0x00, 0x00, 0x1f, 0x82, 0x00, 0x80, 0x00, 
-  0x00, 0x00, 0x00, 0x7c, 0x00, 0xc0, 0x00, 
-  0x00, 0x00, 0x00, 0x08, 0x10, 0x40, 0x00, 
-  0x00, 0x00, 0x00, 0x08, 0x2f, 0xe0, 0x00, 
-  0x00, 0x00, 0x00, 0x04, 0x40, 0x3e, 0x00, 
-  0x00, 0x00, 0x00, 0x03, 0x80, 0x01, 0xc0, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-};
-
-const lv_img_dsc_t bongo_cat_right1 = {
-  .header.cf = LV_IMG_CF_INDEXED_1BIT,
-  .header.always_zero = 0,
-  .header.reserved = 0,
-  .header.w = 50,
-  .header.h = 26,
-  .data_size = 190,
-  .data = bongo_cat_right1_map,
-};
-
-#ifndef LV_ATTRIBUTE_IMG_BONGO_CAT_RIGHT2
-#define LV_ATTRIBUTE_IMG_BONGO_CAT_RIGHT2
-#endif
-
-const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_RIGHT2 uint8_t bongo_cat_right2_map[] = {
-  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
-
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x18, 0x7c, 0x02, 0x00, 0x00, 
-  0x00, 0x00, 0x20, 0x07, 0xc5, 0x00, 0x00, 
-  0x00, 0x00, 0x40, 0x00, 0x79, 0x00, 0x00, 
-  0x00, 0x18, 0x80, 0x00, 0x11, 0x00, 0x00, 
-  0x00, 0x24, 0x80, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x43, 0x00, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x40, 0x08, 0x00, 0x02, 0x00, 0x00, 
-  0x00, 0x40, 0x14, 0x10, 0x02, 0x00, 0x00, 
-  0xe0, 0x20, 0x00, 0x28, 0x02, 0x00, 0x00, 
-  0x1f, 0x10, 0x01, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0xfc, 0x03, 0x80, 0x01, 0x80, 0x00, 
-  0x00, 0x03, 0xe0, 0x00, 0x00, 0x80, 0x00, 
-  0x00, 0x00, 0x1f, 0x82, 0x00, 0x80, 0x00, 
-  0x00, 0x00, 0x00, 0x7c, 0x00, 0xc0, 0x00, 
-  0x00, 0x00, 0x00, 0x08, 0x10, 0x40, 0x00, 
-  0x00, 0x00, 0x00, 0x08, 0x2f, 0xe0, 0x00, 
-  0x00, 0x00, 0x00, 0x04, 0x40, 0x3e, 0x00, 
-  0x00, 0x00, 0x00, 0x33, 0x80, 0x01, 0xc0, 
-  0x00, 0x00, 0x00, 0x20, 0x20, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-};
-
-const lv_img_dsc_t bongo_cat_right2 = {
-  .header.cf = LV_IMG_CF_INDEXED_1BIT,
-  .header.always_zero = 0,
-  .header.reserved = 0,
-  .header.w = 50,
-  .header.h = 26,
-  .data_size = 190,
-  .data = bongo_cat_right2_map,
-};
-
-#ifndef LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH1
-#define LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH1
-#endif
-
-const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH1 uint8_t bongo_cat_both1_map[] = {
-  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
-
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x18, 0x7c, 0x02, 0x00, 0x00, 
-  0x00, 0x00, 0x20, 0x07, 0xc5, 0x00, 0x00, 
-  0x00, 0x00, 0x40, 0x00, 0x79, 0x00, 0x00, 
-  0x00, 0x00, 0x80, 0x00, 0x11, 0x00, 0x00, 
-  0x00, 0x00, 0x80, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x01, 0x08, 0x00, 0x02, 0x00, 0x00, 
-  0x00, 0x02, 0x14, 0x10, 0x02, 0x00, 0x00, 
-  0xe0, 0x04, 0x00, 0x28, 0x02, 0x00, 0x00, 
-  0x1f, 0x08, 0x01, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0xf0, 0x03, 0x80, 0x01, 0x80, 0x00, 
-  0x00, 0x10, 0x20, 0x00, 0x00, 0x80, 0x00, 
-  0x00, 0x10, 0x7f, 0x82, 0x00, 0x80, 0x00, 
-  0x00, 0x09, 0x80, 0x7c, 0x00, 0xc0, 0x00, 
-  0x00, 0x06, 0x00, 0x08, 0x10, 0x40, 0x00, 
-  0x00, 0x00, 0x00, 0x08, 0x2f, 0xe0, 0x00, 
-  0x00, 0x00, 0x00, 0x04, 0x40, 0x3e, 0x00, 
-  0x00, 0x00, 0x00, 0x03, 0x80, 0x01, 0xc0, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-};
-
-const lv_img_dsc_t bongo_cat_both1 = {
-  .header.cf = LV_IMG_CF_INDEXED_1BIT,
-  .header.always_zero = 0,
-  .header.reserved = 0,
-  .header.w = 50,
-  .header.h = 26,
-  .data_size = 190,
-  .data = bongo_cat_both1_map,
-};
-
-#ifndef LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH1_OPEN
-#define LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH1_OPEN
-#endif
-
-const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH1_OPEN uint8_t bongo_cat_both1_open_map[] = {
-  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
-
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x18, 0x7c, 0x02, 0x00, 0x00, 
-  0x00, 0x00, 0x20, 0x07, 0xc5, 0x00, 0x00, 
-  0x00, 0x00, 0x40, 0x00, 0x79, 0x00, 0x00, 
-  0x00, 0x00, 0x80, 0x00, 0x11, 0x00, 0x00, 
-  0x00, 0x00, 0x80, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x01, 0x00, 0x00, 0x02, 0x00, 0x00, 
-  0x00, 0x02, 0x08, 0x00, 0x02, 0x00, 0x00, 
-  0xe0, 0x04, 0x00, 0x10, 0x02, 0x00, 0x00, 
-  0x1f, 0x08, 0x01, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0xf0, 0x03, 0x80, 0x01, 0x80, 0x00, 
-  0x00, 0x10, 0x20, 0x00, 0x00, 0x80, 0x00, 
-  0x00, 0x10, 0x7f, 0x82, 0x00, 0x80, 0x00, 
-  0x00, 0x09, 0x80, 0x7c, 0x00, 0xc0, 0x00, 
-  0x00, 0x06, 0x00, 0x08, 0x10, 0x40, 0x00, 
-  0x00, 0x00, 0x00, 0x08, 0x2f, 0xe0, 0x00, 
-  0x00, 0x00, 0x00, 0x04, 0x40, 0x3e, 0x00, 
-  0x00, 0x00, 0x00, 0x03, 0x80, 0x01, 0xc0, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-};
-
-const lv_img_dsc_t bongo_cat_both1_open = {
-  .header.cf = LV_IMG_CF_INDEXED_1BIT,
-  .header.always_zero = 0,
-  .header.reserved = 0,
-  .header.w = 50,
-  .header.h = 26,
-  .data_size = 190,
-  .data = bongo_cat_both1_open_map,
-};
-
-#ifndef LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH2
-#define LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH2
-#endif
-
-const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_BONGO_CAT_BOTH2 uint8_t bongo_cat_both2_map[] = {
-  0x00, 0x00, 0x00, 0x00, 	/*Color of index 0*/
-  0xff, 0xff, 0xff, 0xff, 	/*Color of index 1*/
-
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x18, 0x7c, 0x02, 0x00, 0x00, 
-  0x00, 0x00, 0x20, 0x07, 0xc5, 0x00, 0x00, 
-  0x00, 0x00, 0x40, 0x00, 0x79, 0x00, 0x00, 
-  0x00, 0x00, 0x80, 0x00, 0x11, 0x00, 0x00, 
-  0x00, 0x00, 0x80, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0x01, 0x08, 0x00, 0x02, 0x00, 0x00, 
-  0x00, 0x02, 0x14, 0x10, 0x02, 0x00, 0x00, 
-  0xe0, 0x04, 0x00, 0x28, 0x02, 0x00, 0x00, 
-  0x1f, 0x08, 0x01, 0x00, 0x01, 0x00, 0x00, 
-  0x00, 0xf0, 0x03, 0x80, 0x01, 0x80, 0x00, 
-  0x00, 0x10, 0x20, 0x00, 0x00, 0x80, 0x00, 
-  0x00, 0x10, 0x7f, 0x82, 0x00, 0x80, 0x00, 
-  0x00, 0x09, 0x80, 0x7c, 0x00, 0xc0, 0x00, 
-  0x00, 0x66, 0x00, 0x08, 0x10, 0x40, 0x00, 
-  0x00, 0x40, 0x80, 0x08, 0x2f, 0xe0, 0x00, 
-  0x00, 0x04, 0x80, 0x04, 0x40, 0x3e, 0x00, 
-  0x00, 0x0c, 0x00, 0x33, 0x80, 0x01, 0xc0, 
-  0x00, 0x00, 0x00, 0x20, 0x20, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-};
-
-const lv_img_dsc_t bongo_cat_both2 = {
-  .header.cf = LV_IMG_CF_INDEXED_1BIT,
-  .header.always_zero = 0,
-  .header.reserved = 0,
-  .header.w = 50,
-  .header.h = 26,
-  .data_size = 190,
-  .data = bongo_cat_both2_map,
-};
-
-
-
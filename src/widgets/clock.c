@@ -1,13 +1,165 @@
 #include "clock.h"
-#include <stdio.h>
-#include <stdlib.h>  // abs()
+#include <stdlib.h>  // llabs()
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <zmk/display.h>
 
 #include "fonts/lv_font_jetbrainsmono_24.h"
 #include "fonts/lv_font_jetbrainsmono_40.h"
+#include "fonts/clock_digits_40.h"
+#include "hid_command.h"
+
+LOG_MODULE_REGISTER(clock_widget, LOG_LEVEL_DBG);
+
+/*
+ * HID 时间命令：
+ *   [hour][min][sec]                                        仅时间，整秒精度
+ *   [hour][min][sec][unix 秒 u32][毫秒 u16][时区 分钟 i16]  完整时间，hour/min/sec 被忽略
+ * 两种格式前 3 字节相同，旧固件收到完整格式时仍能显示正确的时间。
+ */
+#define HID_CMD_CLOCK_SYNC 170
+#define CLOCK_SYNC_FULL_LEN 11
+
+#define MS_PER_DAY (24LL * 3600 * 1000)
+
+// 两次同步间隔至少这么长才用来估计漂移，太短时主机发送延迟的抖动占主导
+#define CLOCK_DRIFT_MIN_INTERVAL_MS (10 * 60 * 1000)
+// 误差超过该值说明主机时间被调整过，不是晶振漂移
+#define CLOCK_DRIFT_MAX_ERROR_MS 5000
+// 漂移估计的上限，32 kHz 晶振通常在 ±50 ppm 以内
+#define CLOCK_DRIFT_MAX_PPB 500000
+// 整秒精度的同步只修正一秒以上的误差
+#define CLOCK_COARSE_THRESHOLD_MS 1000
+// tick 在秒边界之后稍晚执行，避免漂移修正让它落在边界前
+#define CLOCK_TICK_SLACK_MS 5
 
-static void clock_tick(struct k_timer *timer);
+static void clock_tick(struct k_work *work);
 static void clock_update_display(struct zmk_widget_clock *widget);
 
+// HID 命令操作的实例
+static struct zmk_widget_clock *clock_instance;
+
+// HH:MM 的四个数字，之后是秒的两个数字
+#define CLOCK_HM_DIGITS 4
+
+// 下标与 clock_digits_40 相同，最后一个是冒号
+static const char *const clock_digit_text[CLOCK_DIGITS_40_COUNT] = {
+    "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", ":",
+};
+
+/* =========================
+ * 数字格
+ * ========================= */
+// JetBrains Mono 为等宽字体，所有数字和冒号宽度相同
+static lv_coord_t clock_cell_width(const lv_font_t *font) {
+    return lv_font_get_glyph_width(font, '0', 0);
+}
+
+// 固定大小的透明容器，放 n 个数字格
+static lv_obj_t *clock_group_create(lv_obj_t *parent, const lv_font_t *font, int cells) {
+    lv_obj_t *group = lv_obj_create(parent);
+    if (!group) {
+        return NULL;
+    }
+
+    lv_obj_remove_style_all(group);
+    lv_obj_clear_flag(group, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(group, clock_cell_width(font) * cells, lv_font_get_line_height(font));
+    return group;
+}
+
+/*
+ * 一个字符宽的标签，大小固定，文字变化时只重绘这一格，
+ * 不会触发父容器重新计算大小和重新对齐
+ */
+static lv_obj_t *clock_cell_create(lv_obj_t *parent, const lv_font_t *font, lv_color_t color,
+                                   int index) {
+    lv_obj_t *cell = lv_label_create(parent);
+
+    lv_obj_set_style_text_font(cell, font, 0);
+    lv_obj_set_style_text_color(cell, color, 0);
+    lv_label_set_long_mode(cell, LV_LABEL_LONG_CLIP);
+    lv_obj_set_size(cell, clock_cell_width(font), lv_font_get_line_height(font));
+    lv_obj_set_pos(cell, clock_cell_width(font) * index, 0);
+    return cell;
+}
+
+/*
+ * HH:MM 的字符格：启用图集时是图片，直接复制预先混合好的 RGB565 像素，
+ * 不经过字体解码和逐像素的透明度混合
+ */
+static lv_obj_t *clock_hm_cell_create(lv_obj_t *parent, lv_color_t color, int index) {
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_CLOCK_DIGIT_ATLAS)
+    lv_obj_t *cell = lv_img_create(parent);
+    lv_obj_set_pos(cell, clock_cell_width(&lv_font_jetbrainsmono_40) * index, 0);
+    return cell;
+#else
+    return clock_cell_create(parent, &lv_font_jetbrainsmono_40, color, index);
+#endif
+}
+
+static void clock_cell_set(lv_obj_t *cell, bool hm, uint8_t value) {
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_CLOCK_DIGIT_ATLAS)
+    if (hm) {
+        lv_img_set_src(cell, &clock_digits_40[value]);
+        return;
+    }
+#endif
+    lv_label_set_text_static(cell, clock_digit_text[value]);
+}
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_CLOCK_BENCH)
+/* =========================
+ * 渲染耗时对比
+ * ========================= */
+#define CLOCK_BENCH_ROUNDS 20
+#define CLOCK_BENCH_W (24 * 5)
+#define CLOCK_BENCH_H 30
+
+/*
+ * 把 "12:34" 分别用字体和图集画到离屏画布上，比较一次完整 HH:MM 重绘的耗时。
+ * 只测 LVGL 的渲染，不包括 SPI 传输。
+ */
+static void clock_bench_run(void) {
+    static lv_color_t buf[CLOCK_BENCH_W * CLOCK_BENCH_H];
+    static const uint8_t digits[] = {1, 2, CLOCK_DIGITS_40_COLON, 3, 4};
+
+    lv_obj_t *canvas = lv_canvas_create(lv_scr_act());
+    lv_canvas_set_buffer(canvas, buf, CLOCK_BENCH_W, CLOCK_BENCH_H, LV_IMG_CF_TRUE_COLOR);
+    lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+
+    lv_draw_label_dsc_t label_dsc;
+    lv_draw_label_dsc_init(&label_dsc);
+    label_dsc.font = &lv_font_jetbrainsmono_40;
+    label_dsc.color = lv_color_white();
+
+    lv_draw_img_dsc_t img_dsc;
+    lv_draw_img_dsc_init(&img_dsc);
+
+    uint32_t start = k_cycle_get_32();
+    for (int i = 0; i < CLOCK_BENCH_ROUNDS; i++) {
+        lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
+        lv_canvas_draw_text(canvas, 0, 0, CLOCK_BENCH_W, &label_dsc, "12:34");
+    }
+    uint32_t font_us = k_cyc_to_us_floor32(k_cycle_get_32() - start) / CLOCK_BENCH_ROUNDS;
+
+    start = k_cycle_get_32();
+    for (int i = 0; i < CLOCK_BENCH_ROUNDS; i++) {
+        lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
+        for (int j = 0; j < ARRAY_SIZE(digits); j++) {
+            lv_canvas_draw_img(canvas, j * 24, 0, &clock_digits_40[digits[j]], &img_dsc);
+        }
+    }
+    uint32_t atlas_us = k_cyc_to_us_floor32(k_cycle_get_32() - start) / CLOCK_BENCH_ROUNDS;
+
+    // 两次都包含填充背景，差值即为字形渲染的差别
+    LOG_INF("HH:MM 重绘：字体 %u us，图集 %u us", font_us, atlas_us);
+
+    lv_obj_del(canvas);
+}
+#endif
+
 /* =========================
  * 初始化
  * ========================= */
@@ -25,6 +177,12 @@ int zmk_widget_clock_init(struct zmk_widget_clock *widget, lv_obj_t *parent) {
     widget->minute = 0;
     widget->second = 0;
     widget->has_sync = false;
+    widget->has_date = false;
+    widget->has_drift_base = false;
+    widget->epoch_offset_ms = 0;
+    widget->anchor_uptime_ms = 0;
+    widget->drift_ppb = 0;
+    widget->tz_offset_min = 0;
 
     /* ========= 根容器 ========= */
     widget->obj = lv_obj_create(parent);
@@ -40,49 +198,63 @@ int zmk_widget_clock_init(struct zmk_widget_clock *widget, lv_obj_t *parent) {
     /* 让容器包裹内容 */
     lv_obj_set_size(widget->obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
 
+    const lv_font_t *hm_font = &lv_font_jetbrainsmono_40;
+    const lv_font_t *sec_font = &lv_font_jetbrainsmono_24;
+
     /* ========= HH:MM ========= */
-    widget->label_hm = lv_label_create(widget->obj);
+    widget->label_hm = clock_group_create(widget->obj, hm_font, 5);
     if (!widget->label_hm) {
         lv_obj_del(widget->obj);
         widget->obj = NULL;
         return -ENOMEM;
     }
-    
-    lv_label_set_text(widget->label_hm, "00:00");
-    lv_obj_set_style_text_font(widget->label_hm, &lv_font_jetbrainsmono_40, 0);
-    lv_obj_set_style_text_color(widget->label_hm, lv_color_white(), 0);
-    lv_obj_set_size(widget->label_hm, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
 
     /* 保持容器内顶部左对齐 */
     lv_obj_align(widget->label_hm, LV_ALIGN_TOP_LEFT, 0, 0);
 
     /* ========= 秒 ========= */
-    widget->label_sec = lv_label_create(widget->obj);
+    widget->label_sec = clock_group_create(widget->obj, sec_font, 2);
     if (!widget->label_sec) {
         lv_obj_del(widget->obj);
         widget->obj = NULL;
         widget->label_hm = NULL;
         return -ENOMEM;
     }
-    
-    lv_label_set_text(widget->label_sec, "00");
-    lv_obj_set_style_text_font(widget->label_sec, &lv_font_jetbrainsmono_24, 0);
-    lv_obj_set_style_text_color(widget->label_sec, lv_color_make(155, 155, 225), 0);
-    lv_obj_set_size(widget->label_sec, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
 
-    /* 秒数相对于 HH:MM 右下对齐 */
+    /* 秒数相对于 HH:MM 右下对齐，格子宽度固定，之后不再需要重新对齐 */
     lv_obj_align_to(widget->label_sec, widget->label_hm,
                     LV_ALIGN_OUT_RIGHT_BOTTOM, 6, 2);
 
+    /* ========= 数字格 ========= */
+    lv_color_t hm_color = lv_color_white();
+    lv_color_t sec_color = lv_color_make(155, 155, 225);
+
+    widget->digits[0] = clock_hm_cell_create(widget->label_hm, hm_color, 0);
+    widget->digits[1] = clock_hm_cell_create(widget->label_hm, hm_color, 1);
+    lv_obj_t *colon = clock_hm_cell_create(widget->label_hm, hm_color, 2);
+    widget->digits[2] = clock_hm_cell_create(widget->label_hm, hm_color, 3);
+    widget->digits[3] = clock_hm_cell_create(widget->label_hm, hm_color, 4);
+    widget->digits[4] = clock_cell_create(widget->label_sec, sec_font, sec_color, 0);
+    widget->digits[5] = clock_cell_create(widget->label_sec, sec_font, sec_color, 1);
+    clock_cell_set(colon, true, CLOCK_DIGITS_40_COLON);
+
+    for (int i = 0; i < CLOCK_DIGITS; i++) {
+        clock_cell_set(widget->digits[i], i < CLOCK_HM_DIGITS, 0);
+        widget->digit_values[i] = 0;
+    }
+
     /* ========= 根容器整体偏移 ========= */
     lv_obj_align(widget->obj, LV_ALIGN_TOP_LEFT, 0, 0);
 
-    /* ========= 本地 1s tick ========= */
-    k_timer_init(&widget->timer, clock_tick, NULL);
-    k_timer_user_data_set(&widget->timer, widget);
-    
-    // 暂时不启动定时器，等待同步后再启动
-    // k_timer_start(&widget->timer, K_SECONDS(1), K_SECONDS(1));
+    /* ========= 秒边界 tick，在显示工作队列中运行 ========= */
+    // 同步后才开始调度
+    k_work_init_delayable(&widget->tick_work, clock_tick);
+
+    clock_instance = widget;
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_CLOCK_BENCH)
+    clock_bench_run();
+#endif
 
     return 0;
 }
@@ -90,113 +262,263 @@ int zmk_widget_clock_init(struct zmk_widget_clock *widget, lv_obj_t *parent) {
 /* =========================
  * 显示更新
  * ========================= */
+// 只更新变化的数字格，每秒通常只有秒的个位需要重绘
 static void clock_update_display(struct zmk_widget_clock *widget) {
     if (!widget || !widget->obj || !widget->label_hm || !widget->label_sec) {
         return;
     }
-    
-    char buf_hm[8];
-    char buf_s[4];
-
-    snprintf(buf_hm, sizeof(buf_hm), "%02d:%02d",
-             widget->hour, widget->minute);
-    snprintf(buf_s, sizeof(buf_s), "%02d",
-             widget->second);
 
-    lv_label_set_text(widget->label_hm, buf_hm);
-    lv_label_set_text(widget->label_sec, buf_s);
+    uint8_t values[CLOCK_DIGITS] = {
+        widget->hour / 10,   widget->hour % 10,
+        widget->minute / 10, widget->minute % 10,
+        widget->second / 10, widget->second % 10,
+    };
 
-    /* 重新对齐，防止文本宽度变化 */
-    lv_obj_align_to(
-        widget->label_sec,
-        widget->label_hm,
-        LV_ALIGN_OUT_RIGHT_BOTTOM,
-        6,
-        2
-    );
+    for (int i = 0; i < CLOCK_DIGITS; i++) {
+        if (values[i] != widget->digit_values[i]) {
+            clock_cell_set(widget->digits[i], i < CLOCK_HM_DIGITS, values[i]);
+            widget->digit_values[i] = values[i];
+        }
+    }
 }
 
 /* =========================
- * 每秒 tick
+ * 时间模型
  * ========================= */
-static void clock_tick(struct k_timer *timer) {
-    struct zmk_widget_clock *widget = k_timer_user_data_get(timer);
-    
-    if (!widget || !widget->has_sync) {
+static int64_t floor_div(int64_t a, int64_t b) {
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+// 当前 UTC 毫秒
+static int64_t clock_now_ms(const struct zmk_widget_clock *widget) {
+    int64_t uptime = k_uptime_get();
+    int64_t elapsed = uptime - widget->anchor_uptime_ms;
+
+    return uptime + widget->epoch_offset_ms + elapsed * widget->drift_ppb / 1000000000LL;
+}
+
+static int64_t clock_local_ms(const struct zmk_widget_clock *widget) {
+    return clock_now_ms(widget) + (int64_t)widget->tz_offset_min * 60 * 1000;
+}
+
+// 天数 -> 公历日期，1970-01-01 为第 0 天
+static void civil_from_days(int64_t days, uint16_t *year, uint8_t *month, uint8_t *day) {
+    days += 719468;
+    int64_t era = floor_div(days, 146097);
+    uint32_t doe = (uint32_t)(days - era * 146097);
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+
+    *year = (uint16_t)(yoe + era * 400 + (m <= 2));
+    *month = m;
+    *day = doy - (153 * mp + 2) / 5 + 1;
+}
+
+static void clock_anchor(struct zmk_widget_clock *widget, int64_t uptime, int64_t utc_ms) {
+    widget->epoch_offset_ms = utc_ms - uptime;
+    widget->anchor_uptime_ms = uptime;
+    widget->has_sync = true;
+
+    // 立即刷新显示并重新对齐到秒边界
+    k_work_reschedule_for_queue(zmk_display_work_q(), &widget->tick_work, K_NO_WAIT);
+}
+
+/*
+ * 用相隔足够久的两次同步估计晶振漂移：
+ * 主机时间走过的毫秒数与 uptime 走过的毫秒数之差，除以间隔
+ */
+static void clock_update_drift(struct zmk_widget_clock *widget, int64_t uptime, int64_t utc_ms) {
+    if (!widget->has_drift_base) {
+        widget->drift_base_uptime_ms = uptime;
+        widget->drift_base_utc_ms = utc_ms;
+        widget->has_drift_base = true;
         return;
     }
 
-    widget->second++;
-    if (widget->second >= 60) {
-        widget->second = 0;
-        widget->minute++;
-    }
-    if (widget->minute >= 60) {
-        widget->minute = 0;
-        widget->hour++;
+    int64_t interval = uptime - widget->drift_base_uptime_ms;
+    if (interval < CLOCK_DRIFT_MIN_INTERVAL_MS) {
+        return;
     }
-    if (widget->hour >= 24) {
-        widget->hour = 0;
+
+    int64_t measured = ((utc_ms - widget->drift_base_utc_ms) - interval) * 1000000000LL / interval;
+
+    // 第一次测量直接采用，之后与旧值平均，平滑主机发送延迟的抖动
+    if (widget->drift_ppb != 0) {
+        measured = (widget->drift_ppb + measured) / 2;
     }
+    widget->drift_ppb = CLAMP(measured, -CLOCK_DRIFT_MAX_PPB, CLOCK_DRIFT_MAX_PPB);
+
+    LOG_DBG("时钟漂移 %d ppb（间隔 %lld s）", widget->drift_ppb, interval / 1000);
 
-    clock_update_display(widget);
+    widget->drift_base_uptime_ms = uptime;
+    widget->drift_base_utc_ms = utc_ms;
 }
 
 /* =========================
- * HID 同步
+ * 秒边界 tick
  * ========================= */
-void zmk_widget_clock_sync(struct zmk_widget_clock *widget,
-                           uint8_t hour,
-                           uint8_t minute,
-                           uint8_t second,
-                           int sync_threshold_s) {
-    if (!widget || !widget->obj) {
+static void clock_tick(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct zmk_widget_clock *widget = CONTAINER_OF(dwork, struct zmk_widget_clock, tick_work);
+
+    if (!widget->has_sync) {
         return;
     }
-    
-    if (!widget->has_sync) {
+
+    int64_t local = clock_local_ms(widget);
+    int64_t ms_of_day = local - floor_div(local, MS_PER_DAY) * MS_PER_DAY;
+    uint32_t sec_of_day = ms_of_day / 1000;
+
+    uint8_t hour = sec_of_day / 3600;
+    uint8_t minute = sec_of_day / 60 % 60;
+    uint8_t second = sec_of_day % 60;
+
+    if (hour != widget->hour || minute != widget->minute || second != widget->second) {
         widget->hour = hour;
         widget->minute = minute;
         widget->second = second;
-        widget->has_sync = true;
-        
-        // 首次同步后启动定时器
-        k_timer_start(&widget->timer, K_SECONDS(1), K_SECONDS(1));
-        
         clock_update_display(widget);
+    }
+
+    // 下一次在下一个秒边界之后执行，不累积定时器延迟
+    k_work_schedule_for_queue(zmk_display_work_q(), &widget->tick_work,
+                              K_MSEC(1000 - ms_of_day % 1000 + CLOCK_TICK_SLACK_MS));
+}
+
+/* =========================
+ * HID 同步
+ * ========================= */
+void zmk_widget_clock_sync(struct zmk_widget_clock *widget, int64_t utc_ms, int16_t tz_offset_min,
+                           bool learn_drift) {
+    if (!widget || !widget->obj) {
         return;
     }
 
-    int local_seconds =
-        widget->hour * 3600 +
-        widget->minute * 60 +
-        widget->second;
+    int64_t uptime = k_uptime_get();
 
-    int hid_seconds =
-        hour * 3600 +
-        minute * 60 +
-        second;
+    if (widget->has_sync) {
+        int64_t error = utc_ms - clock_now_ms(widget);
 
-    if (abs(hid_seconds - local_seconds) > sync_threshold_s) {
-        widget->hour = hour;
-        widget->minute = minute;
-        widget->second = second;
-        clock_update_display(widget);
+        if (!learn_drift && llabs(error) < CLOCK_COARSE_THRESHOLD_MS &&
+            tz_offset_min == widget->tz_offset_min) {
+            return;
+        }
+        if (learn_drift && llabs(error) > CLOCK_DRIFT_MAX_ERROR_MS) {
+            // 主机时间被调整过，从这次同步开始重新测量
+            LOG_INF("时钟跳变 %lld ms", error);
+            widget->has_drift_base = false;
+        }
+    }
+
+    if (learn_drift) {
+        clock_update_drift(widget, uptime, utc_ms);
+    }
+
+    widget->tz_offset_min = tz_offset_min;
+    clock_anchor(widget, uptime, utc_ms);
+}
+
+// 只有时分秒的同步：取离当前本地时间最近的那一天，跨午夜时不会差一天
+static int64_t clock_tod_to_utc(const struct zmk_widget_clock *widget, uint8_t hour,
+                                uint8_t minute, uint8_t second) {
+    int64_t tod_ms = (hour * 3600 + minute * 60 + second) * 1000LL;
+    int64_t tz_ms = (int64_t)widget->tz_offset_min * 60 * 1000;
+
+    if (!widget->has_sync) {
+        return tod_ms - tz_ms;
+    }
+
+    int64_t local = clock_local_ms(widget);
+    int64_t candidate = floor_div(local, MS_PER_DAY) * MS_PER_DAY + tod_ms;
+
+    if (candidate - local > MS_PER_DAY / 2) {
+        candidate -= MS_PER_DAY;
+    } else if (local - candidate > MS_PER_DAY / 2) {
+        candidate += MS_PER_DAY;
     }
+    return candidate - tz_ms;
 }
 
+static int clock_hid_sync(const uint8_t *payload, uint8_t len) {
+    if (!clock_instance) {
+        return -ENODEV;
+    }
+
+    // 单命令报告补 0 到报告长度，unix 秒为 0 表示只有时分秒
+    uint32_t unix_s = len >= CLOCK_SYNC_FULL_LEN ? sys_get_le32(&payload[3]) : 0;
+
+    if (unix_s != 0) {
+        uint16_t ms = sys_get_le16(&payload[7]);
+        int16_t tz = (int16_t)sys_get_le16(&payload[9]);
+
+        if (ms > 999 || tz < -14 * 60 || tz > 14 * 60) {
+            return -EINVAL;
+        }
+
+        clock_instance->has_date = true;
+        zmk_widget_clock_sync(clock_instance, (int64_t)unix_s * 1000 + ms, tz, true);
+        return 0;
+    }
+
+    if (payload[0] > 23 || payload[1] > 59 || payload[2] > 59) {
+        return -EINVAL;
+    }
+
+    zmk_widget_clock_sync(clock_instance,
+                          clock_tod_to_utc(clock_instance, payload[0], payload[1], payload[2]),
+                          clock_instance->tz_offset_min, false);
+    return 0;
+}
+
+static int clock_hid_query(uint8_t *out, uint8_t max_len) {
+    if (!clock_instance || !clock_instance->has_sync) {
+        return -ENODATA;
+    }
+
+    uint8_t len = clock_instance->has_date ? CLOCK_SYNC_FULL_LEN : 3;
+    if (max_len < len) {
+        return -ENOSPC;
+    }
+
+    out[0] = clock_instance->hour;
+    out[1] = clock_instance->minute;
+    out[2] = clock_instance->second;
+
+    if (clock_instance->has_date) {
+        int64_t now = clock_now_ms(clock_instance);
+        sys_put_le32((uint32_t)(now / 1000), &out[3]);
+        sys_put_le16((uint16_t)(now % 1000), &out[7]);
+        sys_put_le16((uint16_t)clock_instance->tz_offset_min, &out[9]);
+    }
+    return len;
+}
+
+HID_COMMAND_DEFINE_WITH_STATE(clock_sync, HID_CMD_CLOCK_SYNC, 3, clock_hid_sync, clock_hid_query);
+
 lv_obj_t *zmk_widget_clock_obj(struct zmk_widget_clock *widget) {
     return widget ? widget->obj : NULL;
 }
 
+int zmk_widget_clock_get_date(struct zmk_widget_clock *widget, uint16_t *year, uint8_t *month,
+                              uint8_t *day) {
+    if (!widget || !widget->has_sync) {
+        return -ENODATA;
+    }
+
+    civil_from_days(floor_div(clock_local_ms(widget), MS_PER_DAY), year, month, day);
+    return 0;
+}
+
 /* =========================
  * 销毁函数
  * ========================= */
 void zmk_widget_clock_destroy(struct zmk_widget_clock *widget) {
     if (!widget) return;
     
-    // 停止定时器
-    k_timer_stop(&widget->timer);
+    // 停止 tick
+    k_work_cancel_delayable(&widget->tick_work);
     
     // 销毁 LVGL 对象
     if (widget->obj) {
@@ -218,17 +540,8 @@ void zmk_widget_clock_set_time(struct zmk_widget_clock *widget,
                                uint8_t second) {
     if (!widget || !widget->obj) return;
     
-    widget->hour = hour % 24;
-    widget->minute = minute % 60;
-    widget->second = second % 60;
-    widget->has_sync = true;
-    
-    // 如果定时器未启动，启动它
-    if (!k_timer_status_get(&widget->timer)) {
-        k_timer_start(&widget->timer, K_SECONDS(1), K_SECONDS(1));
-    }
-    
-    clock_update_display(widget);
+    clock_anchor(widget, k_uptime_get(),
+                 clock_tod_to_utc(widget, hour % 24, minute % 60, second % 60));
 }
 
 /* =========================
@@ -243,4 +556,4 @@ void zmk_widget_clock_get_time(struct zmk_widget_clock *widget,
     *hour = widget->hour;
     *minute = widget->minute;
     *second = widget->second;
-}
\ No newline at end of file
+}
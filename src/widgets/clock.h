@@ -4,17 +4,39 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+/* 数字格：时十位、时个位、分十位、分个位、秒十位、秒个位 */
+#define CLOCK_DIGITS 6
+
 struct zmk_widget_clock {
     lv_obj_t *obj;
-    lv_obj_t *label_hm;
-    lv_obj_t *label_sec;
+    lv_obj_t *label_hm;   // HH:MM 容器，5 个 40px 字符格
+    lv_obj_t *label_sec;  // 秒容器，2 个 24px 字符格
+
+    lv_obj_t *digits[CLOCK_DIGITS];
+    uint8_t digit_values[CLOCK_DIGITS];  // 当前显示的数字
 
+    /* 当前显示的时间 */
     uint8_t hour;
     uint8_t minute;
     uint8_t second;
     bool has_sync;
+    bool has_date;  // 收到过带日期的同步，否则日期从 1970-01-01 算起
+
+    /*
+     * 时间模型：UTC 毫秒 = k_uptime_get() + epoch_offset_ms + 漂移修正
+     * 漂移修正 = (uptime - anchor_uptime_ms) * drift_ppb / 1e9，由相邻两次同步的误差估计
+     */
+    int64_t epoch_offset_ms;
+    int64_t anchor_uptime_ms;  // 上次同步的 uptime
+    int32_t drift_ppb;         // 本地晶振相对主机时钟偏慢为正
+    int16_t tz_offset_min;     // 本地时间 = UTC + tz_offset_min
 
-    struct k_timer timer;
+    /* 漂移测量的起点，主机时间跳变后重新开始 */
+    int64_t drift_base_uptime_ms;
+    int64_t drift_base_utc_ms;
+    bool has_drift_base;
+
+    struct k_work_delayable tick_work;
 };
 
 /* 初始化时钟 widget，可整体偏移 */
@@ -23,9 +45,15 @@ int zmk_widget_clock_init(struct zmk_widget_clock *widget, lv_obj_t *parent);
 /* 获取时钟根对象 */
 lv_obj_t *zmk_widget_clock_obj(struct zmk_widget_clock *widget);
 
-/* HID 同步时钟 */
-void zmk_widget_clock_sync(struct zmk_widget_clock *widget,
-                           uint8_t hour,
-                           uint8_t minute,
-                           uint8_t second,
-                           int sync_threshold_s);
+/*
+ * 同步到主机时间
+ *
+ * utc_ms 为 Unix 时间（毫秒），tz_offset_min 为时区偏移（分钟）。
+ * learn_drift 为 false 时只校准时间，不用这次的误差估计漂移（例如只有整秒精度的同步）。
+ */
+void zmk_widget_clock_sync(struct zmk_widget_clock *widget, int64_t utc_ms, int16_t tz_offset_min,
+                           bool learn_drift);
+
+/* 当前本地日期，未同步时返回 -ENODATA */
+int zmk_widget_clock_get_date(struct zmk_widget_clock *widget, uint16_t *year, uint8_t *month,
+                              uint8_t *day);
@@ -17,6 +17,7 @@ LOG_MODULE_DECLARE(zmk_widget_connection, CONFIG_ZMK_LOG_LEVEL);
 
 #include "fonts/lv_font_symbol_16.h"
 #include "fonts/lv_font_jetbrainsmono_16.h"
+#include "ble_bond.h"
 
 // profile count
 int total_profile_slots = ZMK_BLE_PROFILE_COUNT;
@@ -29,13 +30,59 @@ static bool listener_initialized = false;
 #define INDICATOR_DOT_SIZE 8                     // 圆点大小
 #define INDICATOR_DOT_SPACING 16                  // 圆点间距(像素)
 #define INDICATOR_DOT_WIDTH INDICATOR_DOT_SPACING // 每个圆点占用的宽度
-#define INDICATOR_BONDED_COLOR lv_color_make(0, 180, 255)   // 亮蓝色：RGB(0, 180, 255)
-#define INDICATOR_UNBONDED_COLOR lv_color_make(255, 140, 0) // 亮橙色：RGB(255, 140, 0)
+#define INDICATOR_BONDED_COLOR LV_COLOR_MAKE(0, 180, 255)   // 亮蓝色：RGB(0, 180, 255)
+#define INDICATOR_UNBONDED_COLOR LV_COLOR_MAKE(255, 140, 0) // 亮橙色：RGB(255, 140, 0)
 #define INDICATOR_UNSELECTED_OPA LV_OPA_50        // 未选中圆点透明度
 #define INDICATOR_SELECTED_OPA LV_OPA_100         // 选中圆点透明度
 #define INDICATOR_SELECTED_BORDER_COLOR lv_color_make(200, 200, 200) // 选中圆点边框颜色
 #define INDICATOR_SELECTED_BORDER_WIDTH 4                           // 选中圆点边框宽度
 
+/* ============================
+ *      圆点共享样式
+ * ============================ */
+
+/*
+ * 所有圆点共用只读的常量样式：一个基础样式，加上按（是否绑定，是否选中）
+ * 区分的四个状态样式。状态变化时只替换变化的圆点的状态样式指针
+ */
+static const lv_style_const_prop_t dot_base_props[] = {
+    LV_STYLE_CONST_RADIUS(INDICATOR_DOT_SIZE / 2),  // 圆形
+    LV_STYLE_CONST_BORDER_WIDTH(0),
+    LV_STYLE_CONST_PAD_TOP(0),
+    LV_STYLE_CONST_PAD_BOTTOM(0),
+    LV_STYLE_CONST_PAD_LEFT(0),
+    LV_STYLE_CONST_PAD_RIGHT(0),
+    LV_STYLE_PROP_INV,
+};
+static LV_STYLE_CONST_INIT(dot_base_style, dot_base_props);
+
+#define DOT_STYLE_DEFINE(name, color, opa)                                                         \
+    static const lv_style_const_prop_t name##_props[] = {                                          \
+        LV_STYLE_CONST_BG_COLOR(color),                                                            \
+        LV_STYLE_CONST_BG_OPA(opa),                                                                \
+        LV_STYLE_PROP_INV,                                                                         \
+    };                                                                                             \
+    static LV_STYLE_CONST_INIT(name, name##_props)
+
+DOT_STYLE_DEFINE(dot_unbonded_style, INDICATOR_UNBONDED_COLOR, INDICATOR_UNSELECTED_OPA);
+DOT_STYLE_DEFINE(dot_bonded_style, INDICATOR_BONDED_COLOR, INDICATOR_UNSELECTED_OPA);
+DOT_STYLE_DEFINE(dot_unbonded_selected_style, INDICATOR_UNBONDED_COLOR, INDICATOR_SELECTED_OPA);
+DOT_STYLE_DEFINE(dot_bonded_selected_style, INDICATOR_BONDED_COLOR, INDICATOR_SELECTED_OPA);
+
+// 下标：bit0 = 已绑定，bit1 = 选中
+static const lv_style_t *const dot_styles[4] = {
+    &dot_unbonded_style,
+    &dot_bonded_style,
+    &dot_unbonded_selected_style,
+    &dot_bonded_selected_style,
+};
+
+static const lv_style_t *dot_style(uint32_t bonded_mask, uint8_t active_profile, int i) {
+    bool bonded = (bonded_mask & BIT(i)) != 0;
+    bool selected = i == active_profile;
+    return dot_styles[(selected << 1) | bonded];
+}
+
 
 // 获取连接状态 - 严格按照transport类型处理
 static struct connection_state get_connection_state(const zmk_event_t *_eh) {
@@ -43,6 +90,8 @@ static struct connection_state get_connection_state(const zmk_event_t *_eh) {
     uint8_t ble_profile_idx = zmk_ble_active_profile_index();
     uint8_t status = CONN_STATUS_USB_DISCONNECTED; // 默认值
     uint8_t profile_num = 0;
+    // 绑定状态来自 ble_bond 的缓存，只在配对、解绑和切换 profile 时重新扫描
+    uint32_t bonded_mask = ble_bond_bonded_mask();
     
     // 根据选择的端点决定显示状态
     switch (selected_endpoint.transport) {
@@ -64,7 +113,7 @@ static struct connection_state get_connection_state(const zmk_event_t *_eh) {
         if (zmk_ble_active_profile_is_connected()) {
             // 已连接
             status = CONN_STATUS_BLE_CONNECTED;
-        } else if (!zmk_ble_active_profile_is_open()) {
+        } else if (bonded_mask & BIT(ble_profile_idx)) {
             // 已绑定但未连接
             status = CONN_STATUS_BLE_BONDED;
         } else {
@@ -76,7 +125,9 @@ static struct connection_state get_connection_state(const zmk_event_t *_eh) {
     
     return (struct connection_state){
         .status = status,
-        .profile_num = profile_num
+        .profile_num = profile_num,
+        .active_profile = ble_profile_idx,
+        .bonded_mask = bonded_mask,
     };
 }
 
@@ -98,52 +149,29 @@ ZMK_DISPLAY_WIDGET_LISTENER(widget_connection, struct connection_state,
 ZMK_SUBSCRIPTION(widget_connection, zmk_endpoint_changed);
 ZMK_SUBSCRIPTION(widget_connection, zmk_ble_active_profile_changed);
 ZMK_SUBSCRIPTION(widget_connection, zmk_usb_conn_state_changed);
+ZMK_SUBSCRIPTION(widget_connection, dongle_ble_bond_state_changed);
 
 
-// 修改 update_profile_indicators 函数
-static void update_profile_indicators(struct zmk_widget_connection *widget) {
+// 只重设状态变化的圆点：绑定状态变了的，以及新旧两个选中的 profile
+static void update_profile_indicators(struct zmk_widget_connection *widget,
+                                      uint8_t active_profile, uint32_t bonded_mask) {
     if (!widget || !widget->indicators_container) return;
-    
-    // 总是获取当前激活的BLE profile索引
-    uint8_t current_profile = zmk_ble_active_profile_index();
-    
-    // 获取所有profile的绑定状态
-    uint32_t profile_bonded_mask = 0;
-    for (int i = 0; i < total_profile_slots; i++) {
-        // 如果该 Profile 不是 "Open" 状态，说明已经 Bonded（已绑定）
-        if (!zmk_ble_profile_is_open(i)) {
-            profile_bonded_mask |= BIT(i);
-        }
+
+    uint32_t changed = widget->bonded_mask ^ bonded_mask;
+    if (active_profile != widget->active_profile) {
+        changed |= BIT(widget->active_profile) | BIT(active_profile);
     }
-    
-    // 更新所有圆点
+
     for (int i = 0; i < total_profile_slots; i++) {
-        if (!widget->profile_dots[i]) continue;
-        
-        // 判断是否已绑定
-        bool is_bonded = (profile_bonded_mask & BIT(i)) != 0;
-        
-        // 设置颜色
-        lv_color_t color = is_bonded ? 
-            INDICATOR_BONDED_COLOR : 
-            INDICATOR_UNBONDED_COLOR;
-        
-        // 设置透明度：当前选中的profile完全显示，其他变暗
-        lv_opa_t opa = (i == current_profile) ? 
-            INDICATOR_SELECTED_OPA : 
-            INDICATOR_UNSELECTED_OPA;
-        
-        lv_obj_set_style_bg_color(widget->profile_dots[i], color, 0);
-        lv_obj_set_style_bg_opa(widget->profile_dots[i], opa, 0);
-        
-        // 如果是当前选中的圆点，添加边框作为背景效果
-        // if (i == current_profile) {
-        //     lv_obj_set_style_border_opa(widget->profile_dots[i], LV_OPA_100, 0);
-        // } else {
-        //     // 非选中圆点移除边框
-        //     lv_obj_set_style_border_width(widget->profile_dots[i], 0, 0);
-        // }
+        if (!(changed & BIT(i)) || !widget->profile_dots[i]) continue;
+
+        lv_obj_replace_style(widget->profile_dots[i],
+                             (lv_style_t *)dot_style(widget->bonded_mask, widget->active_profile, i),
+                             (lv_style_t *)dot_style(bonded_mask, active_profile, i), 0);
     }
+
+    widget->active_profile = active_profile;
+    widget->bonded_mask = bonded_mask;
 }
 
 int zmk_widget_connection_init(struct zmk_widget_connection *widget, lv_obj_t *parent) {
@@ -241,12 +269,10 @@ int zmk_widget_connection_init(struct zmk_widget_connection *widget, lv_obj_t *p
             return -ENOMEM;
         }
         
-        // 设置圆点样式
+        // 设置圆点样式，初始为第 0 个 profile 选中、全部未绑定，与 widget 中缓存的状态一致
         lv_obj_set_size(widget->profile_dots[i], INDICATOR_DOT_SIZE, INDICATOR_DOT_SIZE);
-        lv_obj_set_style_radius(widget->profile_dots[i], INDICATOR_DOT_SIZE / 2, 0); // 圆形
-        lv_obj_set_style_bg_opa(widget->profile_dots[i], INDICATOR_UNSELECTED_OPA, 0);
-        lv_obj_set_style_border_width(widget->profile_dots[i], 0, 0);
-        lv_obj_set_style_pad_all(widget->profile_dots[i], 0, 0);
+        lv_obj_add_style(widget->profile_dots[i], (lv_style_t *)&dot_base_style, 0);
+        lv_obj_add_style(widget->profile_dots[i], (lv_style_t *)dot_style(0, 0, i), 0);
         
         // 设置位置 - 居中
         int dot_x = i * INDICATOR_DOT_WIDTH + 
@@ -255,6 +281,11 @@ int zmk_widget_connection_init(struct zmk_widget_connection *widget, lv_obj_t *p
         lv_obj_set_pos(widget->profile_dots[i], dot_x, dot_y);
     }
 
+    widget->status = 0;  // 不是任何状态，第一次更新一定会设置标签
+    widget->profile = 0;
+    widget->active_profile = 0;
+    widget->bonded_mask = 0;
+
     // 添加到链表
     sys_slist_append(&widgets, &widget->node);
     
@@ -262,11 +293,10 @@ int zmk_widget_connection_init(struct zmk_widget_connection *widget, lv_obj_t *p
     if (!listener_initialized) {
         widget_connection_init();
         listener_initialized = true;
-        connection_update_cb(get_connection_state(NULL));
     }
     
-    // 初始更新profile指示器
-    update_profile_indicators(widget);
+    // 立即显示当前状态
+    zmk_widget_connection_update(widget, get_connection_state(NULL));
 
     return 0;
 }
@@ -281,6 +311,14 @@ void zmk_widget_connection_update(struct zmk_widget_connection *widget,
         return;
     }
 
+    // 圆点只重设变化的部分
+    update_profile_indicators(widget, state.active_profile, state.bonded_mask);
+
+    // 连接状态和 profile 编号都没变时标签不用动
+    if (widget->status == state.status && widget->profile == state.profile_num) {
+        return;
+    }
+
     widget->status = state.status;
     widget->profile = state.profile_num;
     
@@ -340,10 +378,6 @@ void zmk_widget_connection_update(struct zmk_widget_connection *widget,
         lv_label_set_text(widget->profile_num, "");
         break;
     }
-    
-    // 总是更新profile指示器状态
-    // 因为连接状态变化时，绑定状态可能也发生了变化
-    update_profile_indicators(widget);
 }
 
 // 销毁函数
@@ -404,11 +438,9 @@ void zmk_widget_connection_cleanup(void) {
 void zmk_widget_connection_refresh(struct zmk_widget_connection *widget) {
     if (!widget || !widget->obj) return;
     
-    // 更新主连接状态
+    // 更新主连接状态，清掉缓存的状态让标签重设
+    widget->status = 0;
     zmk_widget_connection_update(widget, get_connection_state(NULL));
-    
-    // 更新profile指示器
-    update_profile_indicators(widget);
 }
 
 // 更新profile绑定状态（供外部调用）
@@ -417,18 +449,7 @@ void zmk_widget_connection_update_bonding(struct zmk_widget_connection *widget,
         return;
     }
     
-    if (widget->profile_dots[profile_idx]) {
-        // 更新颜色
-        lv_color_t color = bonded ? 
-            INDICATOR_BONDED_COLOR : 
-            INDICATOR_UNBONDED_COLOR;
-        
-        lv_obj_set_style_bg_color(widget->profile_dots[profile_idx], color, 0);
-        
-        // 更新透明度（如果是当前选中的profile）
-        uint8_t current_profile = zmk_ble_active_profile_index();
-        if (profile_idx == current_profile) {
-            lv_obj_set_style_bg_opa(widget->profile_dots[profile_idx], INDICATOR_SELECTED_OPA, 0);
-        }
-    }
-}
\ No newline at end of file
+    uint32_t bonded_mask = bonded ? (widget->bonded_mask | BIT(profile_idx))
+                                  : (widget->bonded_mask & ~BIT(profile_idx));
+    update_profile_indicators(widget, widget->active_profile, bonded_mask);
+}
@@ -16,6 +16,8 @@ enum conn_status {
 struct connection_state {
     uint8_t status;      // 上述状态之一
     uint8_t profile_num; // BLE profile编号 (1-4)
+    uint8_t active_profile;  // 当前 BLE profile 下标，USB 时也有效，用于圆点
+    uint32_t bonded_mask;    // 已绑定的 profile，bit i 对应 profile i
 };
 
 struct zmk_widget_connection {
@@ -26,8 +28,11 @@ struct zmk_widget_connection {
     lv_obj_t *indicators_container;      // 指示器容器
     lv_obj_t *slider_bg;                 // 滑块背景
     lv_obj_t *profile_dots[ZMK_BLE_PROFILE_COUNT]; // profile圆点数组
+    /* 上次显示的状态，只更新变化的部分 */
     uint8_t status;
     uint8_t profile;
+    uint8_t active_profile;
+    uint32_t bonded_mask;
     sys_snode_t node;
 };
 
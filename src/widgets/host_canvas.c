@@ -0,0 +1,357 @@
+#include "host_canvas.h"
+#include <lvgl.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "hid_command.h"
+#include "hid_response.h"
+
+LOG_MODULE_REGISTER(host_canvas, LOG_LEVEL_DBG);
+
+#define CANVAS_W CONFIG_DONGLE_SCREEN_HOST_CANVAS_WIDTH
+#define CANVAS_H CONFIG_DONGLE_SCREEN_HOST_CANVAS_HEIGHT
+#define PALETTE_SIZE 16
+
+// 画布缓冲区，解码直接写入，不经过 lv_canvas_set_px（每个像素都会刷新整个画布）
+static lv_color_t canvas_buf[CANVAS_W * CANVAS_H];
+// 索引格式的调色板，默认 0 为黑色、1 为白色
+static lv_color_t palette[PALETTE_SIZE];
+
+// HID 命令操作的实例
+static struct zmk_widget_host_canvas *canvas_instance;
+
+// 正在接收的区域
+static struct {
+    bool active;
+    uint8_t seq;
+    uint8_t fmt;
+    uint8_t next_idx;  // 期望的 DATA 序号，不连续说明报告被丢弃
+    lv_area_t area;    // 画布坐标
+    uint16_t col;      // 下一个像素在区域内的位置
+    uint16_t row;
+    uint32_t wire_bytes;
+    uint32_t start_cyc;
+} region;
+
+// 吞吐统计，从收到 REGION 到最后一条 DATA 解码完，包含 USB/BLE 传输时间
+static struct {
+    uint32_t last_pps;
+    uint64_t pixels;
+    uint64_t us;
+    uint64_t wire_bytes;
+    uint16_t errors;
+} stats;
+
+static lv_color_t rgb565_to_color(const uint8_t *p) {
+    uint16_t v = sys_get_be16(p);
+    return lv_color_make((v >> 8) & 0xF8, (v >> 3) & 0xFC, (v << 3) & 0xF8);
+}
+
+static void canvas_invalidate(const lv_area_t *area) {
+    // lv_obj_invalidate_area 使用屏幕坐标
+    lv_area_t abs = *area;
+    lv_area_move(&abs, canvas_instance->obj->coords.x1, canvas_instance->obj->coords.y1);
+    lv_obj_invalidate_area(canvas_instance->obj, &abs);
+}
+
+static int canvas_reply(uint8_t seq, int err) {
+    uint8_t rsp[7];
+
+    if (err) {
+        stats.errors = MIN(stats.errors + 1, UINT16_MAX);
+    }
+
+    rsp[0] = HID_CMD_CANVAS_REGION;
+    rsp[1] = seq;
+    rsp[2] = hid_response_status(err);
+    sys_put_le32(err ? 0 : stats.last_pps, &rsp[3]);
+    hid_response_send(rsp, sizeof(rsp));
+    return err;
+}
+
+/* ============================
+ *      区域解码
+ * ============================ */
+
+static bool region_complete(void) {
+    return region.row >= lv_area_get_height(&region.area);
+}
+
+// 从当前位置按行填充 n 个相同颜色的像素，RLE 的一段可以跨行
+static int region_fill(lv_color_t color, uint32_t n) {
+    uint16_t w = lv_area_get_width(&region.area);
+
+    while (n > 0) {
+        if (region_complete()) {
+            return -EINVAL;  // 数据超出区域
+        }
+
+        uint16_t span = MIN(n, (uint32_t)(w - region.col));
+        lv_color_t *dst = &canvas_buf[(region.area.y1 + region.row) * CANVAS_W +
+                                      region.area.x1 + region.col];
+        lv_color_fill(dst, color, span);
+
+        region.col += span;
+        if (region.col == w) {
+            region.col = 0;
+            region.row++;
+        }
+        n -= span;
+    }
+    return 0;
+}
+
+static int region_decode(const uint8_t *data, uint8_t n) {
+    int err = 0;
+
+    switch (region.fmt) {
+    case HOST_CANVAS_FMT_RGB565:
+        if (n % 2) {
+            return -EINVAL;
+        }
+        for (uint8_t i = 0; i < n && !err; i += 2) {
+            err = region_fill(rgb565_to_color(&data[i]), 1);
+        }
+        break;
+    case HOST_CANVAS_FMT_RGB565_RLE:
+        if (n % 3) {
+            return -EINVAL;
+        }
+        for (uint8_t i = 0; i < n && !err; i += 3) {
+            err = region_fill(rgb565_to_color(&data[i + 1]), data[i] + 1);
+        }
+        break;
+    case HOST_CANVAS_FMT_INDEXED_RLE:
+        for (uint8_t i = 0; i < n && !err; i++) {
+            err = region_fill(palette[data[i] & 0x0F], (data[i] >> 4) + 1);
+        }
+        break;
+    case HOST_CANVAS_FMT_INDEXED4:
+        for (uint8_t i = 0; i < n && !err; i++) {
+            err = region_fill(palette[data[i] >> 4], 1);
+            // 像素数为奇数时最后一个字节的低 4 位是填充
+            if (!err && !region_complete()) {
+                err = region_fill(palette[data[i] & 0x0F], 1);
+            }
+        }
+        break;
+    default:
+        err = -EINVAL;
+        break;
+    }
+    return err;
+}
+
+static void region_finish(void) {
+    uint32_t pixels = lv_area_get_size(&region.area);
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - region.start_cyc);
+
+    stats.last_pps = us ? (uint32_t)((uint64_t)pixels * USEC_PER_SEC / us) : 0;
+    stats.pixels += pixels;
+    stats.us += us;
+    stats.wire_bytes += region.wire_bytes;
+
+    // 只刷新这个区域，曲线图等小区域的更新开销与区域大小成正比
+    canvas_invalidate(&region.area);
+    region.active = false;
+
+    LOG_DBG("区域 %ux%u 完成，%u 字节，%u us", lv_area_get_width(&region.area),
+            lv_area_get_height(&region.area), region.wire_bytes, us);
+    canvas_reply(region.seq, 0);
+}
+
+/* ============================
+ *        HID 命令
+ * ============================ */
+
+static int canvas_region_handler(const uint8_t *payload, uint8_t len) {
+    uint8_t seq = payload[0];
+    uint8_t fmt = payload[1];
+    uint16_t x = sys_get_le16(&payload[2]);
+    uint16_t y = sys_get_le16(&payload[4]);
+    uint16_t w = sys_get_le16(&payload[6]);
+    uint16_t h = sys_get_le16(&payload[8]);
+
+    if (!canvas_instance) {
+        return -ENODEV;
+    }
+
+    if (region.active) {
+        LOG_WRN("上一个区域未完成，已放弃");
+        stats.errors = MIN(stats.errors + 1, UINT16_MAX);
+        region.active = false;
+    }
+
+    if (fmt > HOST_CANVAS_FMT_INDEXED4 || w == 0 || h == 0 || x + w > CANVAS_W ||
+        y + h > CANVAS_H) {
+        return canvas_reply(seq, -EINVAL);
+    }
+
+    region.seq = seq;
+    region.fmt = fmt;
+    region.next_idx = 0;
+    lv_area_set(&region.area, x, y, x + w - 1, y + h - 1);
+    region.col = 0;
+    region.row = 0;
+    region.wire_bytes = 0;
+    region.start_cyc = k_cycle_get_32();
+    region.active = true;
+
+    lv_obj_clear_flag(canvas_instance->obj, LV_OBJ_FLAG_HIDDEN);
+    return 0;
+}
+
+HID_COMMAND_DEFINE(canvas_region, HID_CMD_CANVAS_REGION, 10, canvas_region_handler);
+
+static int canvas_data_handler(const uint8_t *payload, uint8_t len) {
+    uint8_t idx = payload[0];
+    uint8_t n = payload[1];
+    int err;
+
+    // 没有区域时静默丢弃，区域出错时已经回复过一次
+    if (!region.active) {
+        return -ENODEV;
+    }
+
+    if (idx != region.next_idx) {
+        LOG_WRN("区域数据序号 %u，期望 %u", idx, region.next_idx);
+        err = -ESPIPE;
+    } else if (n > len - 2) {
+        err = -EMSGSIZE;
+    } else {
+        region.next_idx++;
+        region.wire_bytes += n;
+        err = region_decode(&payload[2], n);
+    }
+
+    if (err) {
+        region.active = false;
+        return canvas_reply(region.seq, err);
+    }
+
+    if (region_complete()) {
+        region_finish();
+    }
+    return 0;
+}
+
+HID_COMMAND_DEFINE(canvas_data, HID_CMD_CANVAS_DATA, 2, canvas_data_handler);
+
+static int canvas_palette_handler(const uint8_t *payload, uint8_t len) {
+    uint8_t start = payload[1];
+    uint8_t n = payload[2];
+
+    if (start + n > PALETTE_SIZE || 3 + 2 * n > len) {
+        return -EINVAL;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        palette[start + i] = rgb565_to_color(&payload[3 + 2 * i]);
+    }
+    return 0;
+}
+
+HID_COMMAND_DEFINE(canvas_palette, HID_CMD_CANVAS_PALETTE, 3, canvas_palette_handler);
+
+// 区域内每行平移 dx 像素，dx > 0 向左；空出的列保留旧内容，由主机随后发送新的一列
+static int canvas_scroll(const uint8_t *args) {
+    uint16_t x = sys_get_le16(&args[0]);
+    uint16_t y = sys_get_le16(&args[2]);
+    uint16_t w = sys_get_le16(&args[4]);
+    uint16_t h = sys_get_le16(&args[6]);
+    int8_t dx = (int8_t)args[8];
+    uint16_t shift = dx < 0 ? -dx : dx;
+
+    if (w == 0 || h == 0 || x + w > CANVAS_W || y + h > CANVAS_H || shift >= w) {
+        return -EINVAL;
+    }
+
+    for (uint16_t r = 0; r < h; r++) {
+        lv_color_t *row = &canvas_buf[(y + r) * CANVAS_W + x];
+        if (dx > 0) {
+            memmove(row, row + shift, (w - shift) * sizeof(lv_color_t));
+        } else {
+            memmove(row + shift, row, (w - shift) * sizeof(lv_color_t));
+        }
+    }
+
+    lv_area_t area;
+    lv_area_set(&area, x, y, x + w - 1, y + h - 1);
+    canvas_invalidate(&area);
+    return 0;
+}
+
+static int canvas_ctrl_handler(const uint8_t *payload, uint8_t len) {
+    if (!canvas_instance) {
+        return -ENODEV;
+    }
+
+    switch (payload[1]) {
+    case HOST_CANVAS_OP_HIDE:
+        lv_obj_add_flag(canvas_instance->obj, LV_OBJ_FLAG_HIDDEN);
+        return 0;
+    case HOST_CANVAS_OP_SHOW:
+        lv_obj_clear_flag(canvas_instance->obj, LV_OBJ_FLAG_HIDDEN);
+        return 0;
+    case HOST_CANVAS_OP_SCROLL:
+        if (len < 2 + 9) {
+            return -EMSGSIZE;
+        }
+        return canvas_scroll(&payload[2]);
+    default:
+        return -EINVAL;
+    }
+}
+
+HID_COMMAND_DEFINE(canvas_ctrl, HID_CMD_CANVAS_CTRL, 2, canvas_ctrl_handler);
+
+static int canvas_state_query(uint8_t *out, uint8_t max_len) {
+    if (!canvas_instance) {
+        return -ENODATA;
+    }
+    if (max_len < 12) {
+        return -ENOSPC;
+    }
+
+    uint32_t avg_pps = stats.us ? (uint32_t)(stats.pixels * USEC_PER_SEC / stats.us) : 0;
+    // 压缩比 x100，相对于未压缩的 RGB565
+    uint16_t ratio = stats.wire_bytes ? MIN(stats.pixels * 2 * 100 / stats.wire_bytes, UINT16_MAX)
+                                      : 0;
+
+    sys_put_le32(stats.last_pps, &out[0]);
+    sys_put_le32(avg_pps, &out[4]);
+    sys_put_le16(ratio, &out[8]);
+    sys_put_le16(stats.errors, &out[10]);
+    return 12;
+}
+
+HID_STATE_DEFINE(host_canvas, HID_STATE_CANVAS, canvas_state_query);
+
+/* ============================
+ *          初始化
+ * ============================ */
+
+int zmk_widget_host_canvas_init(struct zmk_widget_host_canvas *widget, lv_obj_t *parent) {
+    if (!widget || !parent) {
+        return -EINVAL;
+    }
+
+    widget->obj = lv_canvas_create(parent);
+    lv_canvas_set_buffer(widget->obj, canvas_buf, CANVAS_W, CANVAS_H, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_fill_bg(widget->obj, lv_color_black(), LV_OPA_COVER);
+    // 主机推送第一块区域之前不遮挡其他 widget
+    lv_obj_add_flag(widget->obj, LV_OBJ_FLAG_HIDDEN);
+
+    palette[0] = lv_color_black();
+    palette[1] = lv_color_white();
+
+    canvas_instance = widget;
+
+    return 0;
+}
+
+lv_obj_t *zmk_widget_host_canvas_obj(struct zmk_widget_host_canvas *widget) {
+    return widget ? widget->obj : NULL;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <lvgl.h>
+
+/*
+ * 主机推送的画面区域（专辑封面、CPU 曲线、通知等）
+ *
+ * 主机把一个矩形区域编码后分多条报告发送，固件直接解码到画布缓冲区，
+ * 区域完成后只刷新该矩形。画布默认隐藏，收到第一块区域或 SHOW 后显示。
+ *
+ *   REGION  [seq][fmt][x u16][y u16][w u16][h u16]   开始一个区域
+ *   DATA    [idx][n][data * n]                      区域数据，idx 为区域内的报告序号
+ *   PALETTE [seq][start][n][颜色 u16 * n]            设置索引格式的调色板
+ *   CTRL    [seq][op][...]                          显示/隐藏/滚动
+ *
+ * 颜色均为 RGB565 大端。数据中的编码单元不能跨报告。
+ * 区域完成或出错时回复 [HID_CMD_CANVAS_REGION][seq][status][像素/秒 u32]。
+ */
+#define HID_CMD_CANVAS_REGION 0xBC
+#define HID_CMD_CANVAS_DATA 0xBD
+#define HID_CMD_CANVAS_PALETTE 0xBE
+#define HID_CMD_CANVAS_CTRL 0xBF
+
+enum host_canvas_format {
+    HOST_CANVAS_FMT_RGB565 = 0,       // [颜色 u16]...
+    HOST_CANVAS_FMT_RGB565_RLE = 1,   // [长度-1][颜色 u16]...
+    HOST_CANVAS_FMT_INDEXED_RLE = 2,  // [(长度-1) << 4 | 索引]...，适合曲线图
+    HOST_CANVAS_FMT_INDEXED4 = 3,     // 每字节两个像素，高 4 位在前
+};
+
+enum host_canvas_op {
+    HOST_CANVAS_OP_HIDE = 0,
+    HOST_CANVAS_OP_SHOW = 1,
+    HOST_CANVAS_OP_SCROLL = 2,  // [x u16][y u16][w u16][h u16][dx int8]，区域内左右平移
+};
+
+struct zmk_widget_host_canvas {
+    lv_obj_t *obj;
+};
+
+// 初始化画布，尺寸由 CONFIG_DONGLE_SCREEN_HOST_CANVAS_WIDTH/HEIGHT 决定
+int zmk_widget_host_canvas_init(struct zmk_widget_host_canvas *widget, lv_obj_t *parent);
+
+// 获取画布对象
+lv_obj_t *zmk_widget_host_canvas_obj(struct zmk_widget_host_canvas *widget);
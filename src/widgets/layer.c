@@ -10,6 +10,7 @@
 #include <zmk/keymap.h>
 
 #include "fonts/lv_font_montserrat_custom_24.h"
+#include "hid_command.h"
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -69,6 +70,19 @@ ZMK_DISPLAY_WIDGET_LISTENER(widget_layer, struct layer_state,
 
 ZMK_SUBSCRIPTION(widget_layer, zmk_layer_state_changed);
 
+/* ============================
+ *      HID 状态查询
+ * ============================ */
+static int layer_hid_query(uint8_t *out, uint8_t max_len) {
+    if (max_len < 1) {
+        return -ENOSPC;
+    }
+    out[0] = zmk_keymap_highest_layer_active();
+    return 1;
+}
+
+HID_STATE_DEFINE(layer, HID_STATE_LAYER, layer_hid_query);
+
 /* ============================
  *      初始化 Layer Widget
  * ============================ */
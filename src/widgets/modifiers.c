@@ -2,6 +2,10 @@
 #include <lvgl.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/modifiers_state_changed.h>
 #include <zmk/hid.h>
 #include <string.h>
 
@@ -10,8 +14,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 // 字体声明
 LV_FONT_DECLARE(nerd_modifiers_28);
 
-// 全局widget引用
-static struct zmk_widget_modifiers *global_widget = NULL;
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
 
 // 系统类型（默认为未知）
 static enum system_type current_system = SYS_UNKNOWN;
@@ -31,38 +34,76 @@ static const char *gui_icons[] = {
     "󰘳",  // SYS_MACOS - macOS通用图标（可以改为苹果图标）
 };
 
-// 设置系统类型
-void zmk_widget_modifiers_set_system_type(enum system_type type)
+// 修饰键在 HID 报告中的位（左右两边合并），下标与 mod_order 中的值相同
+static const uint8_t mod_masks[MOD_COUNT] = {
+    (MOD_LCTL | MOD_RCTL),  // Ctrl
+    (MOD_LSFT | MOD_RSFT),  // Shift
+    (MOD_LALT | MOD_RALT),  // Alt
+    (MOD_LGUI | MOD_RGUI),  // GUI
+};
+
+/*
+ * 显示文本缓存
+ *
+ * 显示的修饰键序列（已按方向排好）编码为 0..MOD_TEXT_KEYS-1 的键：
+ * 先按长度分段，段内为排列序号。每个键的文本在第一次用到时拼接一次，
+ * 标签用 lv_label_set_text_static 直接引用缓存，之后只需查表。
+ * 只有 GUI 图标与系统类型有关，切换系统类型时清空缓存
+ */
+#define MOD_ICON_MAX 4  // 图标的 UTF-8 最大字节数
+#define MOD_TEXT_MAX (MAX_MOD_ORDER * MOD_ICON_MAX + 1)
+#define MOD_TEXT_KEYS 65  // 1 + 4 + 4*3 + 4*3*2 + 4*3*2*1
+
+// 长度为 n 的序列的第一个键
+static const uint8_t mod_key_base[MAX_MOD_ORDER + 1] = {0, 1, 5, 17, 41};
+
+static char mod_text_cache[MOD_TEXT_KEYS][MOD_TEXT_MAX];
+static uint32_t mod_text_valid[(MOD_TEXT_KEYS + 31) / 32];
+
+// 获取图标（GUI 根据系统类型）
+static const char *mod_icon(uint8_t mod_index)
 {
-    if (type < SYS_UNKNOWN || type > SYS_MACOS) {
-        type = SYS_UNKNOWN;
-    }
-    
-    current_system = type;
-    LOG_DBG("Modifiers system type set to: %d", type);
-    
-    // 如果widget已初始化，立即更新显示
-    if (global_widget && global_widget->obj) {
-        zmk_widget_modifiers_update(global_widget);
+    return mod_index == 3 ? gui_icons[current_system] : mod_icons[mod_index];
+}
+
+static uint8_t mod_text_key(const uint8_t *seq, uint8_t n)
+{
+    uint8_t used = 0;
+    uint8_t rank = 0;
+
+    for (int i = 0; i < n; i++) {
+        // 序列中每一位在剩余未用的修饰键里的序号
+        uint8_t smaller = __builtin_popcount(~used & BIT_MASK(seq[i]));
+        rank = rank * (MOD_COUNT - i) + smaller;
+        used |= BIT(seq[i]);
     }
+    return mod_key_base[n] + rank;
 }
 
-// 获取GUI图标（根据系统类型）
-static const char *get_gui_icon(void)
+static const char *mod_text_get(const uint8_t *seq, uint8_t n)
 {
-    return gui_icons[current_system];
+    uint8_t key = mod_text_key(seq, n);
+    char *text = mod_text_cache[key];
+
+    if (mod_text_valid[key / 32] & BIT(key % 32)) {
+        return text;
+    }
+
+    size_t len = 0;
+    for (int i = 0; i < n; i++) {
+        const char *icon = mod_icon(seq[i]);
+        size_t icon_len = strlen(icon);
+        memcpy(&text[len], icon, icon_len);
+        len += icon_len;
+    }
+    text[len] = '\0';
+    mod_text_valid[key / 32] |= BIT(key % 32);
+    return text;
 }
 
 // 简化版：检查修饰键变化并更新顺序
 static void update_simple_order(struct zmk_widget_modifiers *widget, uint8_t current_mods)
 {
-    static const uint8_t mod_masks[4] = {
-        (MOD_LCTL | MOD_RCTL),  // Ctrl
-        (MOD_LSFT | MOD_RSFT),  // Shift
-        (MOD_LALT | MOD_RALT),  // Alt
-        (MOD_LGUI | MOD_RGUI),  // GUI
-    };
-    
     uint8_t last_mods = widget->last_mods;
     
     // 检查每个修饰键的变化
@@ -100,89 +141,61 @@ static void update_simple_order(struct zmk_widget_modifiers *widget, uint8_t cur
     }
 }
 
-// 构建显示文本
-static void build_display_text(struct zmk_widget_modifiers *widget, uint8_t current_mods, char *text, size_t text_size)
+// 当前显示的文本：按下顺序中仍按着的修饰键，再按方向排列
+static const char *display_text(struct zmk_widget_modifiers *widget, uint8_t current_mods)
 {
-    int idx = 0;
-    
-    if (widget->extend_left) {
-        // 向左延伸：先按的键在左边（正常顺序）
-        for (int i = 0; i < widget->order_count; i++) {
-            uint8_t mod_index = widget->mod_order[i];
-            
-            // 确保这个修饰键当前仍然按下
-            uint8_t mask = 0;
-            switch (mod_index) {
-                case 0: mask = (MOD_LCTL | MOD_RCTL); break;
-                case 1: mask = (MOD_LSFT | MOD_RSFT); break;
-                case 2: mask = (MOD_LALT | MOD_RALT); break;
-                case 3: mask = (MOD_LGUI | MOD_RGUI); break;
-            }
-            
-            if (current_mods & mask) {
-                const char *icon = NULL;
-                if (mod_index == 3) {
-                    // GUI键，根据系统类型选择图标
-                    icon = get_gui_icon();
-                } else {
-                    icon = mod_icons[mod_index];
-                }
-                
-                if (icon) {
-                    idx += snprintf(&text[idx], text_size - idx, "%s", icon);
-                }
-            }
-        }
-    } else {
-        // 向右延伸：先按的键在右边（反向顺序）
-        for (int i = widget->order_count - 1; i >= 0; i--) {
-            uint8_t mod_index = widget->mod_order[i];
-            
-            // 确保这个修饰键当前仍然按下
-            uint8_t mask = 0;
-            switch (mod_index) {
-                case 0: mask = (MOD_LCTL | MOD_RCTL); break;
-                case 1: mask = (MOD_LSFT | MOD_RSFT); break;
-                case 2: mask = (MOD_LALT | MOD_RALT); break;
-                case 3: mask = (MOD_LGUI | MOD_RGUI); break;
-            }
-            
-            if (current_mods & mask) {
-                const char *icon = NULL;
-                if (mod_index == 3) {
-                    // GUI键，根据系统类型选择图标
-                    icon = get_gui_icon();
-                } else {
-                    icon = mod_icons[mod_index];
-                }
-                
-                if (icon) {
-                    idx += snprintf(&text[idx], text_size - idx, "%s", icon);
-                }
-            }
+    uint8_t seq[MAX_MOD_ORDER];
+    uint8_t n = 0;
+
+    for (int i = 0; i < widget->order_count; i++) {
+        // 向左延伸：先按的键在左边（正常顺序）；向右延伸：先按的键在右边（反向顺序）
+        uint8_t mod_index = widget->extend_left ? widget->mod_order[i]
+                                                : widget->mod_order[widget->order_count - 1 - i];
+        if (current_mods & mod_masks[mod_index]) {
+            seq[n++] = mod_index;
         }
     }
+    return mod_text_get(seq, n);
 }
 
-// 更新修饰键显示
-void zmk_widget_modifiers_update(struct zmk_widget_modifiers *widget)
+// 设置系统类型
+void zmk_widget_modifiers_set_system_type(enum system_type type)
 {
-    if (!widget || !widget->obj) {
+    if (type < SYS_UNKNOWN || type > SYS_MACOS) {
+        type = SYS_UNKNOWN;
+    }
+    
+    if (type == current_system) {
         return;
     }
     
-    uint8_t current_mods = zmk_hid_get_keyboard_report()->body.modifiers;
+    current_system = type;
+    memset(mod_text_valid, 0, sizeof(mod_text_valid));
+    LOG_DBG("Modifiers system type set to: %d", type);
     
-    // 更新按键顺序
-    update_simple_order(widget, current_mods);
+    // 立即按新的系统类型重画已初始化的 widget
+    struct zmk_widget_modifiers *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        if (widget->obj && widget->last_mods) {
+            lv_label_set_text_static(widget->obj, display_text(widget, widget->last_mods));
+        }
+    }
+}
+
+// 按给定的修饰键状态更新显示，只在显示工作队列中调用
+static void modifiers_apply(struct zmk_widget_modifiers *widget, uint8_t current_mods)
+{
+    if (!widget || !widget->obj) {
+        return;
+    }
     
-    // 如果状态没有变化，不更新显示（但第一次初始化时需要更新）
-    static bool first_update = true;
-    if (!first_update && widget->last_mods == current_mods) {
+    // 如果状态没有变化，不更新显示（init 中 last_mods 为 0xFF，第一次一定更新）
+    if (widget->last_mods == current_mods) {
         return;
     }
     
-    first_update = false;
+    // 更新按键顺序
+    update_simple_order(widget, current_mods);
     widget->last_mods = current_mods;
     
     if (current_mods == 0) {
@@ -195,15 +208,17 @@ void zmk_widget_modifiers_update(struct zmk_widget_modifiers *widget)
         // 显示修饰键标签
         lv_obj_clear_flag(widget->obj, LV_OBJ_FLAG_HIDDEN);
         
-        // 构建显示文本
-        char text[32] = "";
-        build_display_text(widget, current_mods, text, sizeof(text));
-        
-        // 更新标签文本
-        lv_label_set_text(widget->obj, text);
+        // 标签直接引用缓存中的文本，不复制
+        lv_label_set_text_static(widget->obj, display_text(widget, current_mods));
     }
 }
 
+// 更新修饰键显示
+void zmk_widget_modifiers_update(struct zmk_widget_modifiers *widget)
+{
+    modifiers_apply(widget, zmk_hid_get_keyboard_report()->body.modifiers);
+}
+
 // 设置排列方向
 void zmk_widget_modifiers_set_direction(struct zmk_widget_modifiers *widget, bool extend_left)
 {
@@ -213,14 +228,40 @@ void zmk_widget_modifiers_set_direction(struct zmk_widget_modifiers *widget, boo
     LOG_DBG("Modifiers direction set to: %s", extend_left ? "LEFT" : "RIGHT");
 }
 
-// 定时器回调函数
-static void modifiers_timer_cb(struct k_timer *timer)
+/* ============================
+ *      事件监听器
+ * ============================ */
+
+struct modifiers_state {
+    uint8_t mods;
+};
+
+/*
+ * 在触发事件的线程中读取 HID 报告里的修饰键。监听器按名称排序，
+ * hid_listener 先于 widget_modifiers 处理同一个按键事件，读到的已是新状态；
+ * 隐式修饰键（如 LS(A)）只出现在按键事件中，所以两个事件都订阅
+ */
+static struct modifiers_state modifiers_get_state(const zmk_event_t *eh)
 {
-    struct zmk_widget_modifiers *widget = k_timer_user_data_get(timer);
-    zmk_widget_modifiers_update(widget);
+    return (struct modifiers_state){
+        .mods = zmk_hid_get_keyboard_report()->body.modifiers,
+    };
 }
 
-static struct k_timer modifiers_timer;
+// 在显示工作队列中运行，可以安全调用 LVGL
+static void modifiers_update_cb(struct modifiers_state state)
+{
+    struct zmk_widget_modifiers *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        modifiers_apply(widget, state.mods);
+    }
+}
+
+ZMK_DISPLAY_WIDGET_LISTENER(widget_modifiers, struct modifiers_state,
+                            modifiers_update_cb, modifiers_get_state)
+
+ZMK_SUBSCRIPTION(widget_modifiers, zmk_keycode_state_changed);
+ZMK_SUBSCRIPTION(widget_modifiers, zmk_modifiers_state_changed);
 
 int zmk_widget_modifiers_init(struct zmk_widget_modifiers *widget, lv_obj_t *parent)
 {
@@ -228,9 +269,6 @@ int zmk_widget_modifiers_init(struct zmk_widget_modifiers *widget, lv_obj_t *par
         return -EINVAL;
     }
     
-    // 保存全局引用
-    global_widget = widget;
-    
     // 初始化结构体
     memset(widget, 0, sizeof(struct zmk_widget_modifiers));
     widget->extend_left = true;  // 默认向左延伸
@@ -245,7 +283,7 @@ int zmk_widget_modifiers_init(struct zmk_widget_modifiers *widget, lv_obj_t *par
     }
     
     // 设置初始文本
-    lv_label_set_text(widget->obj, "-");
+    lv_label_set_text_static(widget->obj, "-");
     
     // 设置字体和颜色
     lv_obj_set_style_text_font(widget->obj, &nerd_modifiers_28, 0);
@@ -253,13 +291,10 @@ int zmk_widget_modifiers_init(struct zmk_widget_modifiers *widget, lv_obj_t *par
     
     // 注意：不在 init 函数中设置任何位置
     
-    // 初始化定时器
-    k_timer_init(&modifiers_timer, modifiers_timer_cb, NULL);
-    k_timer_user_data_set(&modifiers_timer, widget);
-    k_timer_start(&modifiers_timer, K_MSEC(100), K_MSEC(100));
+    sys_slist_append(&widgets, &widget->node);
     
-    // 立即更新一次显示状态
-    zmk_widget_modifiers_update(widget);
+    // 立即更新一次显示状态，之后只在修饰键事件时更新
+    widget_modifiers_init();
     
     return 0;
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <lvgl.h>
+#include <zephyr/kernel.h>
 #include <zmk/hid.h>
 #include "sysicon.h"
 
@@ -7,6 +8,7 @@
 #define MAX_MOD_ORDER 4  // 最多记录4个修饰键的顺序
 
 struct zmk_widget_modifiers {
+    sys_snode_t node;
     lv_obj_t *obj;               // 标签对象
     uint8_t last_mods;           // 上次的修饰键状态
     uint8_t mod_order[MAX_MOD_ORDER];  // 按键顺序记录
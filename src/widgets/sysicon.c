@@ -3,8 +3,19 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 
+#include "hid_command.h"
+#include "modifiers.h"
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+// HID 系统类型命令：payload[0]=系统类型 (1=Windows, 2=Linux, 3=macOS)
+#define HID_CMD_SYSTEM_TYPE 173
+
+uint8_t system_type = 0;  // 最近一次收到的系统类型，0 表示未设置
+
+// HID 命令操作的实例
+static struct zmk_widget_sysicon *sysicon_instance;
+
 // 字体声明
 LV_FONT_DECLARE(nerd_modifiers_28);
 
@@ -83,6 +94,8 @@ int zmk_widget_sysicon_init(struct zmk_widget_sysicon *widget, lv_obj_t *parent,
     // 初始显示
     update_sysicon_display(widget);
 
+    sysicon_instance = widget;
+
     return 0;
 }
 
@@ -108,6 +121,32 @@ void zmk_widget_sysicon_set_system(struct zmk_widget_sysicon *widget, enum syste
     LOG_DBG("System type changed to: %d", system_type);
 }
 
+static int sysicon_hid_set_system(const uint8_t *payload, uint8_t len) {
+    // 保存系统类型到全局变量，供其他模块使用
+    system_type = payload[0];
+    LOG_DBG("System type updated: %d", system_type);
+
+    // 更新系统图标显示（转换为枚举类型）
+    if (sysicon_instance) {
+        zmk_widget_sysicon_set_system(sysicon_instance, (enum system_type)system_type);
+    }
+
+    // 更新修饰键widget的系统类型
+    zmk_widget_modifiers_set_system_type((enum system_type)system_type);
+    return 0;
+}
+
+static int sysicon_hid_query(uint8_t *out, uint8_t max_len) {
+    if (max_len < 1) {
+        return -ENOSPC;
+    }
+    out[0] = system_type;
+    return 1;
+}
+
+HID_COMMAND_DEFINE_WITH_STATE(system_type, HID_CMD_SYSTEM_TYPE, 1, sysicon_hid_set_system,
+                              sysicon_hid_query);
+
 lv_obj_t *zmk_widget_sysicon_obj(struct zmk_widget_sysicon *widget) {
     return widget ? widget->obj : NULL;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <lvgl.h>
 #include <zephyr/kernel.h>
 
+#include "hid_command.h"
+
 #define VOLUME_MIN 0
 #define VOLUME_MAX 100
 #define VOLUME_DEFAULT 100
@@ -10,8 +12,14 @@
 #define ANIM_DURATION 300
 #define ALIGN_SPACING 5
 
+// HID 音量命令：payload[0]=volume
+#define HID_CMD_VOLUME 171
+
 static const lv_color_t COLOR_GRAY = LV_COLOR_MAKE(0x50, 0x50, 0x50);
 
+// HID 命令操作的实例
+static struct zmk_widget_volume *volume_instance;
+
 int zmk_widget_volume_init(struct zmk_widget_volume *widget, lv_obj_t *parent, 
                           struct zmk_widget_clock *clock_widget) {
     if (!widget || !parent || !clock_widget) {
@@ -43,6 +51,8 @@ int zmk_widget_volume_init(struct zmk_widget_volume *widget, lv_obj_t *parent,
     lv_obj_set_size(widget->bar, width, BAR_HEIGHT);
     lv_obj_align_to(widget->obj, clock_widget->label_hm, LV_ALIGN_OUT_BOTTOM_LEFT, 0, ALIGN_SPACING);
 
+    volume_instance = widget;
+
     return 0;
 }
 
@@ -89,4 +99,25 @@ void zmk_widget_volume_set(struct zmk_widget_volume *widget, int value) {
 
     widget->volume = value;
     lv_obj_set_style_bg_color(widget->bar, calculate_color(value), LV_PART_INDICATOR);
-}
\ No newline at end of file
+}
+
+static int volume_hid_set(const uint8_t *payload, uint8_t len) {
+    if (!volume_instance) {
+        return -ENODEV;
+    }
+    zmk_widget_volume_set(volume_instance, payload[0]);
+    return 0;
+}
+
+static int volume_hid_query(uint8_t *out, uint8_t max_len) {
+    if (!volume_instance) {
+        return -ENODATA;
+    }
+    if (max_len < 1) {
+        return -ENOSPC;
+    }
+    out[0] = volume_instance->volume;
+    return 1;
+}
+
+HID_COMMAND_DEFINE_WITH_STATE(volume, HID_CMD_VOLUME, 1, volume_hid_set, volume_hid_query);
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+/*
+ * Minimal stand-in for the ZMK event manager.
+ * There is no dispatch: ZMK_LISTENER(mod, cb) only exposes cb as zmk_listener_<mod>,
+ * and the tests call it directly with an event they built (see fakes.h).
+ */
+
+#define ZMK_EV_EVENT_BUBBLE 0
+#define ZMK_EV_EVENT_HANDLED 1
+
+typedef struct zmk_event_type {
+    const char *name;
+} zmk_event_type;
+
+typedef struct {
+    const zmk_event_type *event;
+} zmk_event_t;
+
+struct zmk_listener {
+    int (*callback)(const zmk_event_t *eh);
+};
+
+#define ZMK_EVENT_DECLARE(event_type)                                                              \
+    struct event_type##_event {                                                                    \
+        zmk_event_t header;                                                                        \
+        struct event_type data;                                                                    \
+    };                                                                                             \
+    extern const zmk_event_type zmk_event_##event_type;                                            \
+    static inline struct event_type *as_##event_type(const zmk_event_t *eh) {                      \
+        return eh->event == &zmk_event_##event_type ? &((struct event_type##_event *)eh)->data     \
+                                                    : NULL;                                        \
+    }
+
+#define ZMK_EVENT_IMPL(event_type)                                                                 \
+    const zmk_event_type zmk_event_##event_type = {.name = #event_type}
+
+#define ZMK_LISTENER(mod, cb) const struct zmk_listener zmk_listener_##mod = {.callback = (cb)}
+
+#define ZMK_SUBSCRIPTION(mod, ev_type) extern const struct zmk_listener zmk_listener_##mod
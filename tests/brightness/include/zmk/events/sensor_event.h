@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zmk/event_manager.h>
+
+struct zmk_sensor_event {
+    uint8_t sensor_index;
+    int64_t timestamp;
+};
+
+ZMK_EVENT_DECLARE(zmk_sensor_event);
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT avago_apds9960
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+#include <string.h>
+
+#include "fakes.h"
+
+// APDS9960 stand-in, plays back the light readings scripted by the test
+
+#define FAKE_AMBIENT_SCRIPT_SIZE 32
+
+static struct k_spinlock lock;
+static int32_t script[FAKE_AMBIENT_SCRIPT_SIZE] = {50}; // Until a test scripts something else
+static size_t script_len = 1;
+static size_t script_pos;
+static int32_t current;
+static uint32_t fetch_count;
+
+void fake_ambient_script(const int32_t *values, size_t count)
+{
+    __ASSERT(count > 0 && count <= FAKE_AMBIENT_SCRIPT_SIZE, "bad script length %zu", count);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    memcpy(script, values, count * sizeof(values[0]));
+    script_len = count;
+    script_pos = 0;
+    k_spin_unlock(&lock, key);
+}
+
+uint32_t fake_ambient_fetch_count(void)
+{
+    return fetch_count;
+}
+
+static int fake_ambient_sample_fetch(const struct device *dev, enum sensor_channel chan)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    current = script[script_pos];
+    script_pos = (script_pos + 1) % script_len;
+    fetch_count++;
+
+    k_spin_unlock(&lock, key);
+    return 0;
+}
+
+static int fake_ambient_channel_get(const struct device *dev, enum sensor_channel chan,
+                                    struct sensor_value *val)
+{
+    if (chan != SENSOR_CHAN_LIGHT) {
+        return -ENOTSUP;
+    }
+
+    val->val1 = current;
+    val->val2 = 0;
+    return 0;
+}
+
+static const struct sensor_driver_api fake_ambient_api = {
+    .sample_fetch = fake_ambient_sample_fetch,
+    .channel_get = fake_ambient_channel_get,
+};
+
+DEVICE_DT_INST_DEFINE(0, NULL, NULL, NULL, NULL, POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY,
+                      &fake_ambient_api);
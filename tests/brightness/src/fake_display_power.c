@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include "display_power.h"
+#include "fakes.h"
+
+// Records the power states the fade thread asks for, there is no panel to drive
+
+static enum display_power_state state = DISPLAY_POWER_ACTIVE;
+static uint32_t transitions;
+
+int display_power_set_state(enum display_power_state next)
+{
+    if (next != state) {
+        state = next;
+        transitions++;
+    }
+    return 0;
+}
+
+enum display_power_state display_power_get_state(void)
+{
+    return state;
+}
+
+void display_power_note_backlight(uint8_t level)
+{
+    ARG_UNUSED(level);
+}
+
+void display_power_get_stats(struct display_power_stats *stats)
+{
+    *stats = (struct display_power_stats){
+        .state = state,
+        .transitions = transitions,
+    };
+}
+
+uint32_t fake_display_power_transitions(void)
+{
+    return transitions;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT pwm_leds
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/led.h>
+
+#include "fakes.h"
+
+// Backlight stand-in for the pwm-leds node, logs every brightness write with its time
+
+static struct k_spinlock lock;
+static struct fake_led_write writes[FAKE_LED_LOG_SIZE];
+static size_t write_count;
+static int last_value = -1;
+
+static int fake_led_set_brightness(const struct device *dev, uint32_t led, uint8_t value)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    if (write_count < FAKE_LED_LOG_SIZE) {
+        writes[write_count] = (struct fake_led_write){
+            .time_us = k_ticks_to_us_floor64(k_uptime_ticks()),
+            .value = value,
+        };
+    }
+    write_count++;
+    last_value = value;
+
+    k_spin_unlock(&lock, key);
+    return 0;
+}
+
+void fake_led_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    write_count = 0;
+    k_spin_unlock(&lock, key);
+}
+
+size_t fake_led_count(void)
+{
+    return write_count;
+}
+
+const struct fake_led_write *fake_led_get(size_t index)
+{
+    return index < MIN(write_count, FAKE_LED_LOG_SIZE) ? &writes[index] : NULL;
+}
+
+int fake_led_last(void)
+{
+    return last_value;
+}
+
+static const struct led_driver_api fake_led_api = {
+    .set_brightness = fake_led_set_brightness,
+};
+
+DEVICE_DT_INST_DEFINE(0, NULL, NULL, NULL, NULL, POST_KERNEL, CONFIG_LED_INIT_PRIORITY,
+                      &fake_led_api);
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/events/sensor_event.h>
+
+#include "fakes.h"
+
+LOG_MODULE_REGISTER(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+ZMK_EVENT_IMPL(zmk_keycode_state_changed);
+ZMK_EVENT_IMPL(zmk_layer_state_changed);
+ZMK_EVENT_IMPL(zmk_sensor_event);
+
+// Defined by ZMK_LISTENER in brightness.c
+extern const struct zmk_listener zmk_listener_screen_idle;
+
+void fake_key_press(uint32_t keycode)
+{
+    struct zmk_keycode_state_changed_event ev = {
+        .header = {.event = &zmk_event_zmk_keycode_state_changed},
+        .data = {.usage_page = 0x07, .keycode = keycode, .state = true, .timestamp = k_uptime_get()},
+    };
+
+    zmk_listener_screen_idle.callback(&ev.header);
+}
+
+void fake_layer_change(uint8_t layer)
+{
+    struct zmk_layer_state_changed_event ev = {
+        .header = {.event = &zmk_event_zmk_layer_state_changed},
+        .data = {.layer = layer, .state = true, .timestamp = k_uptime_get()},
+    };
+
+    zmk_listener_screen_idle.callback(&ev.header);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "display_power.h"
+
+// Writes the fake backlight keeps per reset, later ones are only counted
+#define FAKE_LED_LOG_SIZE 256
+
+/**
+ * @brief One led_set_brightness call seen by the fake backlight
+ */
+struct fake_led_write {
+    int64_t time_us; // Uptime of the call
+    uint8_t value;
+};
+
+/**
+ * @brief Forget the logged writes, the last value is kept
+ */
+void fake_led_reset(void);
+
+/**
+ * @brief Writes logged since the last reset, including the ones that did not fit the log
+ */
+size_t fake_led_count(void);
+
+/**
+ * @brief Logged write, NULL past the end of the log
+ */
+const struct fake_led_write *fake_led_get(size_t index);
+
+/**
+ * @brief Last value written since boot, -1 before the first write
+ */
+int fake_led_last(void);
+
+/**
+ * @brief Number of display_power_set_state calls that changed the state
+ */
+uint32_t fake_display_power_transitions(void);
+
+/**
+ * @brief Replace the ambient sensor readings
+ * Every sample fetch takes the next value, the script starts over at the end.
+ * A single value holds the light level constant.
+ */
+void fake_ambient_script(const int32_t *values, size_t count);
+
+/**
+ * @brief Sample fetches since boot
+ */
+uint32_t fake_ambient_fetch_count(void);
+
+/**
+ * @brief Run a key press through the brightness key listener like ZMK would
+ */
+void fake_key_press(uint32_t keycode);
+
+/**
+ * @brief Run a layer change through the brightness key listener
+ */
+void fake_layer_change(uint8_t layer);
+
+/**
+ * @brief Start measuring a transition: clears the LED log and remembers the fade statistics
+ */
+void transition_begin(void);
+
+/**
+ * @brief Print the LED writes, fades and duration since transition_begin()
+ */
+void transition_report(const char *name);
+
+/**
+ * @brief Print the writes-per-transition metric over the whole run
+ */
+void transition_summary(void);
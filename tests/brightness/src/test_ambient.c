@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+
+#include "brightness.h"
+#include "fakes.h"
+
+/*
+ * Ambient light pipeline fed by the scripted sensor: raw reading -> EMA -> mapping -> hysteresis.
+ * Raw values 0..100 map to brightness 1..80, the hysteresis is 5 steps.
+ */
+
+#define SETTLE_MS 3000
+
+static void script_constant(int32_t value)
+{
+    fake_ambient_script(&value, 1);
+}
+
+ZTEST(brightness_ambient, test_flicker_is_filtered)
+{
+    // +-8 raw is +-6 brightness steps, one unfiltered reading would pass the hysteresis
+    static const int32_t flicker[] = {58, 42};
+    struct brightness_stats before, after;
+
+    script_constant(50);
+    k_msleep(SETTLE_MS);
+    zassert_equal(fake_led_last(), 40);
+
+    transition_begin();
+    brightness_get_stats(&before);
+    uint32_t fetches = fake_ambient_fetch_count();
+
+    fake_ambient_script(flicker, ARRAY_SIZE(flicker));
+    k_msleep(SETTLE_MS);
+    brightness_get_stats(&after);
+
+    zassert_true(fake_ambient_fetch_count() - fetches >= 4, "sensor was not sampled");
+    zassert_equal(after.transitions, before.transitions, "flicker caused a fade");
+    zassert_equal(fake_led_count(), 0);
+    transition_report("flicker");
+}
+
+ZTEST(brightness_ambient, test_step_is_followed)
+{
+    struct brightness_stats before, after;
+
+    script_constant(50);
+    k_msleep(SETTLE_MS);
+
+    transition_begin();
+    brightness_get_stats(&before);
+
+    script_constant(100);
+    k_msleep(SETTLE_MS);
+    brightness_get_stats(&after);
+
+    // The filter approaches the new level in a few fades and settles at raw 99 (brightness 79),
+    // the last fade lands within the hysteresis of that
+    zassert_between_inclusive(fake_led_last(), 79 - CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_HYSTERESIS, 80);
+    zassert_between_inclusive(after.transitions - before.transitions, 1, 6);
+    transition_report("dark->light");
+}
+
+static void ambient_teardown(void *fixture)
+{
+    transition_summary();
+}
+
+ZTEST_SUITE(brightness_ambient, NULL, NULL, NULL, NULL, ambient_teardown);
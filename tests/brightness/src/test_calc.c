@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+
+#include "brightness_calc.h"
+
+// Same range as the shield defaults, independent of the Kconfig of this test
+static const struct brightness_limits limits = {.min = 1, .max = 80};
+
+ZTEST(brightness_calc, test_fade_plan_skips_tiny_changes)
+{
+    struct brightness_fade_plan plan;
+
+    zassert_false(brightness_fade_plan(40, 40, &plan));
+    zassert_false(brightness_fade_plan(40, 41, &plan));
+    zassert_false(brightness_fade_plan(41, 40, &plan));
+}
+
+ZTEST(brightness_calc, test_fade_plan_steps_and_duration)
+{
+    static const struct {
+        uint8_t from, to;
+        int steps, delay_us;
+    } cases[] = {
+        {10, 12, 6, 83333},  // Fewest steps, shortest fade (500ms)
+        {70, 80, 20, 25000}, // Keyboard step
+        {20, 0, 32, 15625},  // Idle off from the dim level
+        {30, 60, 32, 18750},
+        {0, 80, 32, 31250}, // Longest fade (1000ms)
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(cases); i++) {
+        struct brightness_fade_plan plan;
+
+        zassert_true(brightness_fade_plan(cases[i].from, cases[i].to, &plan));
+        zassert_equal(plan.steps, cases[i].steps, "%d -> %d: %d steps", cases[i].from,
+                      cases[i].to, plan.steps);
+        zassert_equal(plan.delay_us, cases[i].delay_us, "%d -> %d: %d us", cases[i].from,
+                      cases[i].to, plan.delay_us);
+    }
+}
+
+ZTEST(brightness_calc, test_fade_value_endpoints_and_midpoint)
+{
+    zassert_equal(brightness_fade_value(0, 80, 0, 32), 0);
+    zassert_equal(brightness_fade_value(0, 80, 32, 32), 80);
+    zassert_equal(brightness_fade_value(80, 20, 0, 32), 80);
+    zassert_equal(brightness_fade_value(80, 20, 32, 32), 20);
+    zassert_equal(brightness_fade_value(0, 80, 16, 32), 40);
+}
+
+ZTEST(brightness_calc, test_fade_value_eases_in)
+{
+    // A quarter in, the cubic curve is at 1/16 of the way: 5 instead of 20 for a linear fade
+    zassert_equal(brightness_fade_value(0, 80, 8, 32), 5);
+    zassert_equal(brightness_fade_value(80, 0, 8, 32), 75);
+}
+
+ZTEST(brightness_calc, test_fade_value_is_monotonic)
+{
+    uint8_t prev_up = 0;
+    uint8_t prev_down = 80;
+
+    for (int i = 1; i <= 32; i++) {
+        uint8_t up = brightness_fade_value(0, 80, i, 32);
+        uint8_t down = brightness_fade_value(80, 0, i, 32);
+
+        zassert_true(up >= prev_up, "step %d: %d after %d", i, up, prev_up);
+        zassert_true(down <= prev_down, "step %d: %d after %d", i, down, prev_down);
+        prev_up = up;
+        prev_down = down;
+    }
+}
+
+ZTEST(brightness_calc, test_safe_modifier_change)
+{
+    static const struct {
+        uint8_t base;
+        int8_t modifier, desired, expected;
+    } cases[] = {
+        {50, 0, 10, 10},   // Fits
+        {70, 0, 10, 10},   // Ends exactly on max
+        {75, 0, 10, 5},    // Cut at max
+        {80, 0, 10, 0},    // Already at max
+        {40, 30, 20, 10},  // Modifier counts towards the limit
+        {50, 0, -10, -10}, // Fits
+        {5, 0, -10, -4},   // Cut at min
+        {1, 0, -10, 0},    // Already at min
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(cases); i++) {
+        int8_t change = brightness_safe_modifier_change(&limits, cases[i].base, cases[i].modifier,
+                                                        cases[i].desired);
+
+        zassert_equal(change, cases[i].expected, "base %d modifier %d desired %d: %d",
+                      cases[i].base, cases[i].modifier, cases[i].desired, change);
+    }
+}
+
+ZTEST(brightness_calc, test_calculate_with_bounds_in_range)
+{
+    struct brightness_result r = brightness_calculate_with_bounds(&limits, 40, 10, true);
+
+    zassert_equal(r.adjusted_brightness, 40);
+    zassert_equal(r.adjusted_modifier, 10);
+    zassert_equal(r.effective_brightness, 50);
+    zassert_false(r.was_clamped);
+    zassert_false(r.hit_min_limit);
+    zassert_false(r.hit_max_limit);
+}
+
+ZTEST(brightness_calc, test_calculate_with_bounds_clamps_effective)
+{
+    struct brightness_result r = brightness_calculate_with_bounds(&limits, 90, 0, false);
+
+    zassert_equal(r.adjusted_brightness, 80);
+    zassert_equal(r.effective_brightness, 80);
+    zassert_true(r.hit_max_limit);
+
+    // Without ambient constraints the base stays, only the effective value is bounded
+    r = brightness_calculate_with_bounds(&limits, 50, -60, false);
+    zassert_equal(r.adjusted_brightness, 50);
+    zassert_equal(r.adjusted_modifier, -60);
+    zassert_equal(r.effective_brightness, 1);
+    zassert_true(r.hit_min_limit);
+}
+
+ZTEST(brightness_calc, test_calculate_with_bounds_ambient_moves_base)
+{
+    // 50 - 60 is below min: the base is raised until base + modifier is just above it
+    struct brightness_result r = brightness_calculate_with_bounds(&limits, 50, -60, true);
+
+    zassert_equal(r.adjusted_brightness, 62);
+    zassert_equal(r.adjusted_modifier, -60);
+    zassert_equal(r.effective_brightness, 2);
+    zassert_true(r.was_clamped);
+    zassert_true(r.hit_min_limit);
+
+    // 70 + 20 is above max: the base is lowered by the overshoot
+    r = brightness_calculate_with_bounds(&limits, 70, 20, true);
+    zassert_equal(r.adjusted_brightness, 60);
+    zassert_equal(r.effective_brightness, 80);
+    zassert_true(r.was_clamped);
+    zassert_true(r.hit_max_limit);
+}
+
+ZTEST_SUITE(brightness_calc, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+
+#include "activity.h"
+#include "display_power.h"
+#include "fakes.h"
+
+/*
+ * Idle state machine, driven only by scripted key and layer events.
+ * Simulated time makes the timeouts exact: every check below sleeps to a fixed
+ * point relative to the event that started the timers.
+ */
+
+#define KEY_A 0x04
+#define DIM_MS (CONFIG_DONGLE_SCREEN_IDLE_DIM_TIMEOUT_S * 1000)
+#define OFF_MS (CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S * 1000)
+#define DIM_LEVEL 20   // dim_val in screen_idle_thread()
+#define SETTLE_MS 1200 // Longest fade is 1000ms plus its last step
+
+#define HOST_HOLD_MS 2000
+
+// Registered from outside activity.c, like a host application source would be
+ACTIVITY_SOURCE_DEFINE(test_host, ACTIVITY_HOLD, HOST_HOLD_MS);
+
+static uint32_t mark_power;
+
+static void sleep_until(int64_t uptime_ms)
+{
+    k_msleep(MAX(uptime_ms - k_uptime_get(), 0));
+}
+
+static void begin_transition(void)
+{
+    transition_begin();
+    mark_power = fake_display_power_transitions();
+}
+
+ZTEST(brightness_idle, test_brightness_keys)
+{
+    begin_transition();
+    fake_key_press(CONFIG_DONGLE_SCREEN_BRIGHTNESS_DOWN_KEYCODE);
+    k_msleep(SETTLE_MS);
+    zassert_equal(fake_led_last(), 80 - CONFIG_DONGLE_SCREEN_BRIGHTNESS_STEP);
+    zassert_between_inclusive(fake_led_count(), 1, 21, "80 -> 70 has 20 steps");
+    transition_report("key down");
+
+    begin_transition();
+    fake_key_press(CONFIG_DONGLE_SCREEN_BRIGHTNESS_UP_KEYCODE);
+    k_msleep(SETTLE_MS);
+    zassert_equal(fake_led_last(), 80);
+    transition_report("key up");
+
+    // Already at max: no fade, no write
+    begin_transition();
+    fake_key_press(CONFIG_DONGLE_SCREEN_BRIGHTNESS_UP_KEYCODE);
+    k_msleep(SETTLE_MS);
+    zassert_equal(fake_led_count(), 0);
+}
+
+ZTEST(brightness_idle, test_hold_source_postpones_idle)
+{
+    fake_key_press(KEY_A);
+    int64_t t0 = k_uptime_get();
+
+    // Holds until t0 + 3500: no dim at t0 + DIM_MS
+    sleep_until(t0 + 1500);
+    activity_signal(ACTIVITY_SOURCE(test_host));
+    sleep_until(t0 + DIM_MS + 300);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_ACTIVE);
+
+    sleep_until(t0 + 1500 + HOST_HOLD_MS + SETTLE_MS);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_DIMMED);
+
+    // A hold never wakes, but pushes idle off to t0 + 6700
+    begin_transition();
+    activity_signal(ACTIVITY_SOURCE(test_host));
+    sleep_until(t0 + OFF_MS + 300);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_DIMMED);
+    zassert_equal(fake_led_count(), 0);
+}
+
+ZTEST(brightness_idle, test_idle_dim_off_wake)
+{
+    begin_transition();
+    fake_key_press(KEY_A);
+    int64_t t0 = k_uptime_get();
+
+    sleep_until(t0 + DIM_MS - 100);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_ACTIVE);
+    zassert_equal(fake_led_count(), 0, "no writes while active");
+
+    sleep_until(t0 + DIM_MS + SETTLE_MS);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_DIMMED);
+    zassert_equal(fake_led_last(), DIM_LEVEL);
+    zassert_equal(fake_display_power_transitions() - mark_power, 1);
+    transition_report("dim");
+
+    begin_transition();
+    sleep_until(t0 + OFF_MS + SETTLE_MS);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_OFF);
+    zassert_equal(fake_led_last(), 0);
+    zassert_equal(fake_display_power_transitions() - mark_power, 1);
+    transition_report("idle off");
+
+    begin_transition();
+    fake_key_press(KEY_A);
+    k_msleep(SETTLE_MS);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_ACTIVE);
+    zassert_equal(fake_led_last(), 80);
+    transition_report("wake");
+}
+
+ZTEST(brightness_idle, test_layer_change_wakes_dimmed)
+{
+    fake_key_press(KEY_A);
+    sleep_until(k_uptime_get() + DIM_MS + SETTLE_MS);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_DIMMED);
+
+    begin_transition();
+    fake_layer_change(1);
+    k_msleep(SETTLE_MS);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_ACTIVE);
+    zassert_equal(fake_led_last(), 80);
+    transition_report("undim");
+}
+
+ZTEST(brightness_idle, test_toggle_key_survives_typing)
+{
+    begin_transition();
+    fake_key_press(CONFIG_DONGLE_SCREEN_TOGGLE_KEYCODE);
+    k_msleep(SETTLE_MS);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_OFF);
+    zassert_equal(fake_led_last(), 0);
+    transition_report("toggle off");
+
+    // Typing must not undo a manual off
+    begin_transition();
+    fake_key_press(KEY_A);
+    k_msleep(SETTLE_MS);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_OFF);
+    zassert_equal(fake_led_count(), 0);
+
+    fake_key_press(CONFIG_DONGLE_SCREEN_TOGGLE_KEYCODE);
+    k_msleep(SETTLE_MS);
+    zassert_equal(display_power_get_state(), DISPLAY_POWER_ACTIVE);
+    zassert_equal(fake_led_last(), 80);
+    transition_report("toggle on");
+}
+
+// Every test starts on an active screen at full brightness
+static void idle_before(void *fixture)
+{
+    fake_key_press(KEY_A);
+    k_msleep(SETTLE_MS);
+}
+
+static void idle_teardown(void *fixture)
+{
+    transition_summary();
+}
+
+ZTEST_SUITE(brightness_idle, NULL, NULL, idle_before, NULL, idle_teardown);
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+
+#include "brightness.h"
+#include "fakes.h"
+
+// Writes-per-transition metric, from the fake LED log and the brightness statistics
+
+static struct brightness_stats mark;
+
+void transition_begin(void)
+{
+    fake_led_reset();
+    brightness_get_stats(&mark);
+}
+
+void transition_report(const char *name)
+{
+    struct brightness_stats now;
+    size_t writes = fake_led_count();
+    int64_t span_us = 0;
+
+    brightness_get_stats(&now);
+    // Past the end of the log the span only covers the logged writes
+    if (writes > 1) {
+        size_t last = MIN(writes, FAKE_LED_LOG_SIZE) - 1;
+
+        span_us = fake_led_get(last)->time_us - fake_led_get(0)->time_us;
+    }
+
+    TC_PRINT("%-10s %u fade(s), %u LED writes over %d ms, %u writes in the last fade\n", name,
+             now.transitions - mark.transitions, (uint32_t)writes, (int)(span_us / 1000),
+             now.last_transition_writes);
+}
+
+void transition_summary(void)
+{
+    struct brightness_stats stats;
+    uint32_t transitions;
+
+    brightness_get_stats(&stats);
+    transitions = MAX(stats.transitions, 1);
+
+    TC_PRINT("%u fades, %u LED writes: %u.%u writes per transition, at most %u\n",
+             stats.transitions, stats.led_writes, stats.led_writes / transitions,
+             stats.led_writes * 10 / transitions % 10, stats.max_transition_writes);
+}